@@ -4,6 +4,59 @@
 //! \brief External exchange API integrations.
 
 namespace K {
+  static class mClockwork {
+    private:
+      mClock frozen = 0,
+             origin = 0;
+      inline static thread_local mClock turn  = 0;
+      inline static thread_local unsigned int depth = 0;
+    public:
+      mClockwork() {
+        const mClock steady = precise();
+        origin = chrono::duration_cast<chrono::microseconds>(
+          Tclock.time_since_epoch()
+        ).count() - steady;
+      };
+      void tick() {
+        if (!depth++) turn = precise();
+      };
+      void tock() {
+        if (depth and !--depth) turn = 0;
+      };
+      const mClock precise() const {
+        return frozen ?: chrono::duration_cast<chrono::microseconds>(
+          chrono::steady_clock::now().time_since_epoch()
+        ).count();
+      };
+      const mClock stamp() const {
+        return (origin + (turn ?: precise())) / 1000;
+      };
+      const mClock fresh() const {
+        return (origin + precise()) / 1000;
+      };
+      const mClock spent() const {
+        return turn ? precise() - turn : 0;
+      };
+      void freeze(const mClock &epoch) {
+        frozen = epoch * 1000 - origin;
+        if (turn) turn = frozen;
+      };
+      void shift(const mClock &ms) {
+        if (!frozen) return;
+        frozen += ms * 1000;
+        if (turn) turn = frozen;
+      };
+      void thaw() {
+        frozen = 0;
+        if (turn) turn = precise();
+      };
+  } clockwork;
+
+  struct mTurn {
+    mTurn() { clockwork.tick(); };
+    ~mTurn() { clockwork.tock(); };
+  };
+
   enum class mConnectivity: unsigned int {
     Disconnected, Connected
   };
@@ -23,8 +76,68 @@ namespace K {
   static          bool operator ! (mConnectivity k_)                   { return !(unsigned int)k_; };
   static mConnectivity operator * (mConnectivity _k, mConnectivity k_) { return (mConnectivity)((unsigned int)_k * (unsigned int)k_); };
 
-  static string strX(const double &d, const unsigned int &X) { stringstream ss; ss << setprecision(X) << fixed << d; return ss.str(); };
+  static char *strX(char *k, const double &d, const unsigned int &X, const bool &trim = false) {
+    static const unsigned long long pow10[] = {
+      1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+      1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+      100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL
+    };
+    if (X > 17 or !isfinite(d) or abs(d) * pow10[X] >= 9e+18) {
+      const int n = snprintf(k, 352, "%.*f", min(X, 17u), d);             // 352 fits any double up to 17 decimals
+      if (n < 0) *k = 0;
+      return k + (n < 0 ? 0 : min(n, 351));
+    }
+    const double a = abs(d);
+    unsigned long long i = a;
+    const double p = (a - i) * pow10[X],
+                 e = fma(a - i, pow10[X], -p),
+                 r = p - floor(p) - 0.5;
+    unsigned long long f = p;
+    if (r > -e or (r == -e and (X ? f : i) % 2)) ++f;
+    if (f == pow10[X]) f = 0, ++i;
+    if (d < 0 and (i or f)) *k++ = '-';
+    char *const k_ = k;
+    do *k++ = '0' + i % 10; while (i /= 10);
+    reverse(k_, k);
+    if (X) {
+      *k++ = '.';
+      for (char *x = k + X; x != k; f /= 10) *--x = '0' + f % 10;
+      k += X;
+      if (trim) {
+        while (k[-1] == '0') --k;
+        if (k[-1] == '.') --k;
+      }
+    }
+    *k = 0;
+    return k;
+  };
+  static string strX(const double &d, const unsigned int &X) { char k[352]; return string(k, strX(k, d, X)); };
   static string str8(const double &d) { return strX(d, 8); };
+  static const double strD(const char *k) {
+    static const double pow10[] = {
+      1e+0, 1e+1, 1e+2, 1e+3, 1e+4, 1e+5, 1e+6, 1e+7, 1e+8, 1e+9, 1e+10, 1e+11,
+      1e+12, 1e+13, 1e+14, 1e+15, 1e+16, 1e+17, 1e+18, 1e+19, 1e+20, 1e+21, 1e+22
+    };
+    const char *const k_ = k;
+    const bool negative = *k == '-';
+    if (negative or *k == '+') ++k;
+    unsigned long long n = 0;
+    unsigned int digits = 0,
+                 decimals = 0;
+    for (; *k >= '0' and *k <= '9'; ++k, ++digits)
+      n = n * 10 + (*k - '0');
+    if (*k == '.')
+      for (++k; *k >= '0' and *k <= '9'; ++k, ++digits, ++decimals)
+        n = n * 10 + (*k - '0');
+    if (digits > 15 or decimals > 22 or *k == 'e' or *k == 'E')
+      return strtod(k_, nullptr);
+    return (negative ? -1 : 1) * (n / pow10[decimals]);
+  };
+  static const unsigned int decimals(const double &step) {
+    unsigned int X = 0;
+    for (double k = step; X < 17 and abs(k - round(k)) > 1e-9 * fmax(1, k); k *= 10) ++X;
+    return X;
+  };
   static string strL(string s) { transform(s.begin(), s.end(), s.begin(), ::tolower); return s; };
   static string strU(string s) { transform(s.begin(), s.end(), s.begin(), ::toupper); return s; };
 
@@ -39,9 +152,21 @@ namespace K {
       mOrderType type           = mOrderType::Limit;
     mTimeInForce timeInForce    = mTimeInForce::GTC;
             bool isPong         = false,
-                 preferPostOnly = true;
+                 preferPostOnly = true,
+                 zombie         = false,
+                 mature         = false;
           mClock time           = 0,
                  latency        = 0;
+    struct mStamps {
+      mClock decided   = 0,
+             handed    = 0,
+             sent      = 0,
+             acked     = 0,
+             withdrawn = 0,
+             canceled  = 0,
+             closed    = 0;
+      vector<mClock> filled;
+    } stamps;
     mOrder()
     {};
     mOrder(const mRandId &o, const mSide &s, const mPrice &p, const mAmount &q, const bool &i)
@@ -309,6 +434,183 @@ namespace K {
     };
   };
 
+  // single pass SAX decoder of "key/*/0" paths into T, where "*" matches any key or index.
+  template <typename T> class mFields {
+    public:
+      using mSet = function<void(T&, const double&, const string&)>;
+    private:
+      struct mRule {
+        vector<string> path;
+        vector<int> index;
+        mSet set;
+      };
+      vector<mRule> rules;
+      class mSax {
+        private:
+          struct mFrame {
+            unsigned long long mask = 0;
+                           int index = -1;
+          };
+          const vector<mRule> &rules;
+          T &into;
+          array<mFrame, 16> stack;
+          unsigned int depth = 0;
+          unsigned long long match = 0;
+        public:
+          mSax(const vector<mRule> &r, T &k)
+            : rules(r)
+            , into(k)
+          {
+            match = rules.size() == 64 ? ~0ULL : (1ULL << rules.size()) - 1;
+          };
+          bool null()                                           { return scalar(0, ""); };
+          bool boolean(bool val)                                { return scalar(val, ""); };
+          bool number_integer(long long val)                    { return scalar(val, ""); };
+          bool number_unsigned(unsigned long long val)          { return scalar(val, ""); };
+          bool number_float(double val, const std::string &raw) { return scalar(val, raw); };
+          bool string(std::string &val)                         { return scalar(strD(val.data()), val); };
+          template <typename B> bool binary(B &val)             { return false; };
+          bool start_object(size_t)                             { return open(-1); };
+          bool end_object()                                     { return close(); };
+          bool start_array(size_t)                              { return open(0); };
+          bool end_array()                                      { return close(); };
+          bool key(std::string &val) {
+            const mFrame &frame = stack[depth - 1];
+            match = 0;
+            for (unsigned int i = 0; i < rules.size(); ++i)
+              if (frame.mask & (1ULL << i)
+                and (rules[i].path[depth - 1] == "*" or rules[i].path[depth - 1] == val)
+              ) match |= 1ULL << i;
+            return true;
+          };
+          template <typename E> bool parse_error(size_t, const std::string&, const E&) {
+            return false;
+          };
+        private:
+          void element() {
+            if (!depth or stack[depth - 1].index < 0) return;
+            const mFrame &frame = stack[depth - 1];
+            match = 0;
+            for (unsigned int i = 0; i < rules.size(); ++i)
+              if (frame.mask & (1ULL << i)
+                and (rules[i].index[depth - 1] == -1 or rules[i].index[depth - 1] == frame.index)
+              ) match |= 1ULL << i;
+            stack[depth - 1].index++;
+          };
+          void apply(const double &num, const std::string &str) {
+            for (unsigned int i = 0; i < rules.size(); ++i)
+              if (match & (1ULL << i) and rules[i].path.size() == depth)
+                rules[i].set(into, num, str);
+          };
+          bool scalar(const double &num, const std::string &str) {
+            element();
+            apply(num, str);
+            return true;
+          };
+          bool open(const int &index) {
+            if (depth == stack.size()) return false;
+            element();
+            apply(0, "");
+            mFrame &frame = stack[depth++];
+            frame.mask = 0;
+            frame.index = index;
+            for (unsigned int i = 0; i < rules.size(); ++i)
+              if (match & (1ULL << i) and rules[i].path.size() >= depth)
+                frame.mask |= 1ULL << i;
+            return true;
+          };
+          bool close() {
+            --depth;
+            return true;
+          };
+        friend class mFields;
+      };
+    public:
+      mFields(const vector<pair<std::string, mSet>> &fields) {
+        for (const pair<std::string, mSet> &it : fields) {
+          if (rules.size() == 64) break;
+          mRule rule;
+          rule.set = it.second;
+          size_t a = 0, b;
+          while (a < it.first.length()) {
+            b = it.first.find('/', a);
+            if (b == std::string::npos) b = it.first.length();
+            const std::string key = it.first.substr(a, b - a);
+            rule.path.push_back(key);
+            rule.index.push_back(                                            // empty or non-numeric segments are object keys
+              key == "*" ? -1 : (
+                !key.empty() and key.length() < 10
+                  and key.find_first_not_of("0123456789") == std::string::npos
+                    ? stoi(key) : -2
+              )
+            );
+            a = b + 1;
+          }
+          rules.push_back(rule);
+        }
+      };
+      const bool decode(const std::string &data, T &into) const {
+        mSax sax(rules, into);
+        return json::sax_parse(data, &sax) and !sax.depth;
+      };
+  };
+
+  class mHistogram {
+    private:
+      static const unsigned int precision = 7;
+      vector<unsigned long> counts;
+      unsigned long total = 0;
+             mClock lowest  = 0,
+                    highest = 0;
+    public:
+      void record(const mClock &value) {
+        const unsigned int bucket = magnitude(value);
+        const size_t index = ((size_t)bucket << (precision - 1)) + (value >> bucket);
+        if (index >= counts.size()) counts.resize(index + 1);
+        counts[index]++;
+        lowest  = total++ ? min(lowest, value) : value;
+        highest = max(highest, value);
+      };
+      const mClock percentile(const double &p) const {
+        if (!total or p <= 0) return lowest;
+        const unsigned long rank = fmax(1, ceil(total * p / 1e+2));
+        unsigned long seen = 0;
+        for (size_t i = 0; i < counts.size(); ++i)
+          if ((seen += counts[i]) >= rank)
+            return max(lowest, min(highest, upper(i)));
+        return highest;
+      };
+      const unsigned long count() const {
+        return total;
+      };
+      void clear() {
+        counts.clear();
+        total = lowest = highest = 0;
+      };
+      const json stats() const {
+        return {
+          {"count", total           },
+          {  "min", lowest          },
+          {  "p50", percentile(50)  },
+          {  "p90", percentile(90)  },
+          {  "p99", percentile(99)  },
+          {  "max", highest         }
+        };
+      };
+    private:
+      static const unsigned int magnitude(const mClock &value) {
+        return value >> precision
+          ? 64 - __builtin_clzll(value) - precision
+          : 0;
+      };
+      static const mClock upper(const size_t &index) {
+        const unsigned int bucket = index >> precision
+          ? (index >> (precision - 1)) - 1
+          : 0;
+        return ((index - ((size_t)bucket << (precision - 1)) + 1) << bucket) - 1;
+      };
+  };
+
   class mREST {
     public:
       static const char *inet;
@@ -326,25 +628,306 @@ namespace K {
         });
       };
       static const json curl_perform(const string &url, function<void(CURL *curl)> curl_setopt, bool debug = true) {
+        return parse(curl_read(url, curl_setopt, debug));
+      };
+      static const string curl_read(const string &url, function<void(CURL *curl)> curl_setopt, bool debug = true) {
         string reply;
-        CURL *curl = curl_easy_init();
+        const string host = hostname(url);
+        CURL *curl = acquire(host);
         if (curl) {
           curl_setopt(curl);
-          curl_easy_setopt(curl, CURLOPT_USERAGENT, "K");
-          curl_easy_setopt(curl, CURLOPT_INTERFACE, mREST::inet);
-          curl_easy_setopt(curl, CURLOPT_URL, url.data());
-          curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &curl_write);
-          curl_easy_setopt(curl, CURLOPT_WRITEDATA, &reply);
+          curl_defaults(curl, url, &reply);
           CURLcode r = curl_easy_perform(curl);
           if (debug and r != CURLE_OK)
-            reply = string("{\"error\":\"CURL Error: ") + curl_easy_strerror(r) + "\"}";
-          curl_easy_cleanup(curl);
+            reply = curl_error(r);
+          release(host, curl, r == CURLE_OK);
         }
-        return json::accept(reply)
-          ? json::parse(reply)
-          : json::object();
+        return reply;
+      };
+      static const json parse(const string &data) {
+        const json reply = json::parse(data, nullptr, false);
+        return reply.is_discarded()
+          ? json::object()
+          : reply;
+      };
+      static void loop(uS::Loop *const loop) {
+        if (multi().multi or !(multi().multi = curl_multi_init())) return;
+        multi().loop  = loop;
+        multi().timer = new uS::Timer(loop);
+        curl_multi_setopt(multi().multi, CURLMOPT_SOCKETFUNCTION, curl_socket);
+        curl_multi_setopt(multi().multi, CURLMOPT_TIMERFUNCTION, curl_timer);
+      };
+      static void xfer(const string &url, const function<void(const json&)> &reply) {
+        curl_async(url, [](CURL *curl, curl_slist **h_) {
+          curl_easy_setopt(curl, CURLOPT_TIMEOUT, 13L);
+        }, [reply](const string &data) {
+          reply(parse(data));
+        });
+      };
+      static void xfer(const string &url, const string &post, const function<void(const json&)> &reply) {
+        curl_async(url, [&](CURL *curl, curl_slist **h_) {
+          *h_ = curl_slist_append(*h_, "Content-Type: application/x-www-form-urlencoded");
+          curl_easy_setopt(curl, CURLOPT_COPYPOSTFIELDS, post.data());
+        }, [reply](const string &data) {
+          reply(parse(data));
+        });
+      };
+      static void curl_async(const string &url, const function<void(CURL*, curl_slist**)> &curl_setopt, const function<void(const string&)> &reply) {
+        if (!multi().multi) {
+          curl_slist *h_ = nullptr;
+          const string data = curl_read(url, [&](CURL *curl) {
+            curl_setopt(curl, &h_);
+            if (h_) curl_easy_setopt(curl, CURLOPT_HTTPHEADER, h_);
+          });
+          curl_slist_free_all(h_);
+          reply(data);
+          return;
+        }
+        mRequest *const request = new mRequest();
+        request->host  = hostname(url);
+        request->reply = reply;
+        CURL *curl = acquire(request->host);
+        if (!curl) {
+          delete request;
+          reply("");
+          return;
+        }
+        curl_setopt(curl, &request->headers);
+        if (request->headers) curl_easy_setopt(curl, CURLOPT_HTTPHEADER, request->headers);
+        curl_defaults(curl, url, &request->data);
+        curl_easy_setopt(curl, CURLOPT_PRIVATE, request);
+        curl_multi_add_handle(multi().multi, curl);
+      };
+      struct mTiming {
+        mClock dns      = 0,
+               tcp      = 0,
+               tls      = 0,
+               server   = 0,
+               total    = 0;
+          long connects = 0;
+      };
+      static const mTiming probe(const string &url, const bool &connect = false) {
+        mTiming timing;
+        string reply;
+        CURL *curl = curl_easy_init();
+        if (!curl) return timing;
+        if (connect) curl_easy_setopt(curl, CURLOPT_CONNECT_ONLY, 1L);
+        else curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 13L);
+        curl_easy_setopt(curl, CURLOPT_FRESH_CONNECT, 1L);
+        curl_easy_setopt(curl, CURLOPT_FORBID_REUSE, 1L);
+        curl_defaults(curl, url, &reply);
+        const CURLcode r = curl_easy_perform(curl);
+        double dns = 0, tcp = 0, tls = 0, pre = 0, start = 0, total = 0;
+        curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME,    &dns);
+        curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME,       &tcp);
+        curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME,    &tls);
+        curl_easy_getinfo(curl, CURLINFO_PRETRANSFER_TIME,   &pre);
+        curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME, &start);
+        curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME,         &total);
+        curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS,       &timing.connects);
+        curl_easy_cleanup(curl);
+        if (r != CURLE_OK) return timing;
+        timing.dns    = dns * 1e+6;
+        timing.tcp    = fmax(0, tcp - dns) * 1e+6;
+        timing.tls    = tls ? fmax(0, tls - tcp) * 1e+6 : 0;
+        timing.server = start ? fmax(0, start - pre) * 1e+6 : 0;
+        timing.total  = fmax(total, 1e-6) * 1e+6;
+        return timing;
+      };
+      static void warmup(const string &url, const unsigned int &connections = 4) {
+        if (url.empty()) return;
+        vector<future<json>> replies;
+        for (unsigned int i = 0; i < connections; ++i)
+          replies.push_back(::async(launch::async, [&]() {
+            return curl_perform(url, [&](CURL *curl) {
+              curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+              curl_easy_setopt(curl, CURLOPT_TIMEOUT, 13L);
+            }, false);
+          }));
+        for (future<json> &it : replies) it.wait();
+      };
+      static const json stats() {
+        json hosts = json::object();
+        lock_guard<mutex> lock(pool().lock);
+        for (const unordered_map<string, mPool::mHost>::value_type &it : pool().hosts)
+          hosts[it.first] = {
+            {"requests", it.second.requests                           },
+            {   "reuse", it.second.requests
+                           ? 1e+2 * it.second.reused / it.second.requests
+                           : 0                                        },
+            { "latency", it.second.latency                            }
+          };
+        return hosts;
       };
     private:
+      struct mRequest {
+        string host,
+               data;
+        curl_slist *headers = nullptr;
+        function<void(const string&)> reply;
+      };
+      struct mMulti {
+        CURLM     *multi = nullptr;
+        uS::Loop  *loop  = nullptr;
+        uS::Timer *timer = nullptr;
+      };
+      class mSocket: public uS::Poll {
+        public:
+          mSocket(uS::Loop *const loop, const curl_socket_t &fd)
+            : uS::Poll(loop, fd)
+          {
+            setCb([](uS::Poll *poll, int status, int events) {
+              clockwork.tick();
+              curl_action(((mSocket*)poll)->getFd(),
+                (status < 0            ? CURL_CSELECT_ERR : 0)
+                | (events & UV_READABLE ? CURL_CSELECT_IN  : 0)
+                | (events & UV_WRITABLE ? CURL_CSELECT_OUT : 0)
+              );
+              clockwork.tock();
+            });
+          };
+          void watch(const int &events) {
+            if (watching) change(multi().loop, this, events);
+            else start(multi().loop, this, events);
+            watching = true;
+          };
+          void unwatch() {
+            stop(multi().loop);
+            close(multi().loop, [](uS::Poll *poll) {
+              delete (mSocket*)poll;
+            });
+          };
+        private:
+          bool watching = false;
+      };
+      static mMulti &multi() {
+        static mMulti multi;
+        return multi;
+      };
+      static int curl_socket(CURL *curl, curl_socket_t fd, int what, void *userp, void *socketp) {
+        mSocket *socket = (mSocket*)socketp;
+        if (what == CURL_POLL_REMOVE) {
+          if (socket) socket->unwatch();
+          curl_multi_assign(multi().multi, fd, nullptr);
+          return 0;
+        }
+        if (!socket) {
+          socket = new mSocket(multi().loop, fd);
+          curl_multi_assign(multi().multi, fd, socket);
+        }
+        socket->watch(
+          (what & CURL_POLL_IN  ? UV_READABLE : 0)
+          | (what & CURL_POLL_OUT ? UV_WRITABLE : 0)
+        );
+        return 0;
+      };
+      static int curl_timer(CURLM *curlm, long timeout, void *userp) {
+        multi().timer->stop();
+        if (timeout >= 0)
+          multi().timer->start([](uS::Timer *timer) {
+            clockwork.tick();
+            curl_action(CURL_SOCKET_TIMEOUT, 0);
+            clockwork.tock();
+          }, timeout, 0);
+        return 0;
+      };
+      static void curl_action(const curl_socket_t &fd, const int &events) {
+        int running = 0;
+        curl_multi_socket_action(multi().multi, fd, events, &running);
+        CURLMsg *msg;
+        while ((msg = curl_multi_info_read(multi().multi, &running))) {
+          if (msg->msg != CURLMSG_DONE) continue;
+          CURL *curl = msg->easy_handle;
+          const CURLcode r = msg->data.result;
+          mRequest *request = nullptr;
+          curl_easy_getinfo(curl, CURLINFO_PRIVATE, (char**)&request);
+          curl_multi_remove_handle(multi().multi, curl);
+          if (r != CURLE_OK) request->data = curl_error(r);
+          release(request->host, curl, r == CURLE_OK);
+          curl_slist_free_all(request->headers);
+          const string data = move(request->data);
+          const function<void(const string&)> fn = request->reply;
+          delete request;
+          fn(data);
+        }
+      };
+      static void curl_defaults(CURL *curl, const string &url, string *const reply) {
+        curl_easy_setopt(curl, CURLOPT_USERAGENT, "K");
+        curl_easy_setopt(curl, CURLOPT_INTERFACE, mREST::inet);
+        curl_easy_setopt(curl, CURLOPT_URL, url.data());
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &curl_write);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, reply);
+      };
+      static const string curl_error(const CURLcode &r) {
+        return string("{\"error\":\"CURL Error: ") + curl_easy_strerror(r) + "\"}";
+      };
+      struct mPool {
+        struct mHost {
+          vector<CURL*> idle;
+          unsigned long requests = 0,
+                        reused   = 0;
+          double        latency  = 0;
+        };
+        mutex lock,
+              locks[CURL_LOCK_DATA_LAST];
+        unordered_map<string, mHost> hosts;
+        CURLSH *share = nullptr;
+        mPool() {
+          if (!(share = curl_share_init())) return;
+          curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+          curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+          curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+          curl_share_setopt(share, CURLSHOPT_LOCKFUNC, (curl_lock_function)
+            [](CURL *curl, curl_lock_data data, curl_lock_access access, void *pool) {
+              ((mPool*)pool)->locks[data].lock();
+            }
+          );
+          curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, (curl_unlock_function)
+            [](CURL *curl, curl_lock_data data, void *pool) {
+              ((mPool*)pool)->locks[data].unlock();
+            }
+          );
+        };
+      };
+      static mPool &pool() {
+        static mPool pool;
+        return pool;
+      };
+      static const string hostname(const string &url) {
+        const size_t scheme = url.find("://");
+        return url.substr(0, url.find('/', scheme == string::npos ? 0 : scheme + 3));
+      };
+      static CURL *acquire(const string &host) {
+        CURL *curl = nullptr;
+        {
+          lock_guard<mutex> lock(pool().lock);
+          vector<CURL*> &idle = pool().hosts[host].idle;
+          if (!idle.empty()) {
+            curl = idle.back();
+            idle.pop_back();
+          }
+        }
+        if (!curl and (curl = curl_easy_init()) and pool().share)
+          curl_easy_setopt(curl, CURLOPT_SHARE, pool().share);
+        return curl;
+      };
+      static void release(const string &host, CURL *curl, const bool &reusable) {
+        long connects = 1;
+        double total = 0;
+        curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &connects);
+        curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME, &total);
+        if (reusable) curl_easy_reset(curl);
+        lock_guard<mutex> lock(pool().lock);
+        mPool::mHost &stats = pool().hosts[host];
+        stats.latency = stats.requests++
+          ? stats.latency * .9 + total * 1e+2
+          : total * 1e+3;
+        if (reusable and !connects) stats.reused++;
+        if (reusable) stats.idle.push_back(curl);
+        else curl_easy_cleanup(curl);
+      };
       static size_t curl_write(void *buf, size_t size, size_t nmemb, void *up) {
         ((string*)up)->append((char*)buf, size * nmemb);
         return size * nmemb;
@@ -394,111 +977,1128 @@ namespace K {
       }
   };
 
-  class mText {
+  class mInflate {
     public:
-      static string oZip(string k) {
-        z_stream zs;
-        if (inflateInit2(&zs, -15) != Z_OK) return "";
+      mInflate() {
+        ready = inflateInit2(&zs, -15) == Z_OK;
+      };
+      ~mInflate() {
+        if (ready) inflateEnd(&zs);
+      };
+      const bool inflate(const string &k, string &k_) {
+        k_.clear();
+        if (!ready or inflateReset(&zs) != Z_OK) return false;
         zs.next_in = (Bytef*)k.data();
         zs.avail_in = k.size();
         int ret;
-        char outbuffer[32768];
-        string k_;
         do {
-          zs.avail_out = 32768;
-          zs.next_out = (Bytef*)outbuffer;
-          ret = inflate(&zs, Z_SYNC_FLUSH);
-          if (k_.size() < zs.total_out)
-            k_.append(outbuffer, zs.total_out - k_.size());
+          if (k_.capacity() < chunk) k_.reserve(chunk);
+          const size_t len = k_.size();
+          k_.resize(k_.capacity() == len ? len * 2 : k_.capacity());
+          zs.next_out = (Bytef*)&k_[len];
+          zs.avail_out = k_.size() - len;
+          ret = ::inflate(&zs, Z_SYNC_FLUSH);
+          k_.resize(k_.size() - zs.avail_out);
         } while (ret == Z_OK);
-        inflateEnd(&zs);
-        if (ret != Z_STREAM_END) return "";
+        if (ret == Z_STREAM_END) return true;
+        k_.clear();
+        return false;
+      };
+    private:
+      z_stream zs = {};
+      bool ready = false;
+      static const size_t chunk = 32768;
+  };
+
+  class mText {
+    public:
+      static string oZip(string k) {
+        string k_;
+        oZip(k, k_);
         return k_;
       };
+      static const bool oZip(const string &k, string &k_) {
+        static thread_local mInflate zs;
+        return zs.inflate(k, k_);
+      };
       static string oHex(string k) {
-       unsigned int len = k.length();
-        string k_;
-        for (unsigned int i=0; i < len; i+=2) {
-          string byte = k.substr(i, 2);
-          char chr = (char)(int)strtol(byte.data(), NULL, 16);
-          k_.push_back(chr);
+        static const unsigned char nibble[256] = {
+          0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+          0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,1,2,3,4,5,6,7,8,9,0,0,0,0,0,0,
+          0,10,11,12,13,14,15,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+          0,10,11,12,13,14,15,0,0,0,0,0,0,0,0,0
+        };
+        string k_(k.length() / 2, 0);
+        for (unsigned int i = 0; i < k_.length(); ++i)
+          k_[i] = (nibble[(unsigned char)k[i*2]] << 4) | nibble[(unsigned char)k[i*2+1]];
+        return k_;
+      };
+      static string oHex(const unsigned char *const k, const unsigned int &len, const bool &upper = false) {
+        const char *const digits = upper
+          ? "0123456789ABCDEF"
+          : "0123456789abcdef";
+        string k_(len * 2, 0);
+        for (unsigned int i = 0; i < len; ++i) {
+          k_[i*2]   = digits[k[i] >> 4];
+          k_[i*2+1] = digits[k[i] & 15];
         }
         return k_;
       };
       static string oB64(string k) {
-        BIO *bio, *b64;
-        BUF_MEM *bufferPtr;
-        b64 = BIO_new(BIO_f_base64());
-        bio = BIO_new(BIO_s_mem());
-        bio = BIO_push(b64, bio);
-        BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
-        BIO_write(bio, k.data(), k.length());
-        BIO_flush(bio);
-        BIO_get_mem_ptr(bio, &bufferPtr);
-        BIO_set_close(bio, BIO_NOCLOSE);
-        BIO_free_all(bio);
-        return string(bufferPtr->data, bufferPtr->length);
+        static const char digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        string k_(((k.length() + 2) / 3) * 4, '=');
+        const unsigned char *in = (const unsigned char*)k.data();
+        char *out = &k_[0];
+        size_t i = 0;
+        for (; i + 3 <= k.length(); i += 3, in += 3, out += 4) {
+          const unsigned int n = (in[0] << 16) | (in[1] << 8) | in[2];
+          out[0] = digits[n >> 18];
+          out[1] = digits[(n >> 12) & 63];
+          out[2] = digits[(n >> 6) & 63];
+          out[3] = digits[n & 63];
+        }
+        if (i < k.length()) {
+          const unsigned int n = (in[0] << 16) | (i + 1 < k.length() ? in[1] << 8 : 0);
+          out[0] = digits[n >> 18];
+          out[1] = digits[(n >> 12) & 63];
+          if (i + 1 < k.length()) out[2] = digits[(n >> 6) & 63];
+        }
+        return k_;
       };
       static string oB64decode(string k) {
-        BIO *bio, *b64;
-        char buffer[k.length()];
-        b64 = BIO_new(BIO_f_base64());
-        bio = BIO_new_mem_buf(k.data(), k.length());
-        bio = BIO_push(b64, bio);
-        BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
-        BIO_set_close(bio, BIO_NOCLOSE);
-        int len = BIO_read(bio, buffer, k.length());
-        BIO_free_all(bio);
-        return string(buffer, len);
+        static const unsigned char sextet[256] = {
+          64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64, 64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,
+          64,64,64,64,64,64,64,64,64,64,64,62,64,64,64,63, 52,53,54,55,56,57,58,59,60,61,64,64,64,64,64,64,
+          64, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13,14, 15,16,17,18,19,20,21,22,23,24,25,64,64,64,64,64,
+          64,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40, 41,42,43,44,45,46,47,48,49,50,51,64,64,64,64,64,
+          64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64, 64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,
+          64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64, 64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,
+          64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64, 64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,
+          64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64, 64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64
+        };
+        string k_(k.length() / 4 * 3 + 3, 0);
+        const unsigned char *in = (const unsigned char*)k.data();
+        unsigned char *out = (unsigned char*)&k_[0];
+        size_t len = 0;
+        while (len < k.length() and sextet[in[len]] < 64) ++len;
+        size_t i = 0;
+        for (; i + 4 <= len; i += 4, in += 4, out += 3) {
+          const unsigned int n = (sextet[in[0]] << 18) | (sextet[in[1]] << 12) | (sextet[in[2]] << 6) | sextet[in[3]];
+          out[0] = n >> 16;
+          out[1] = n >> 8;
+          out[2] = n;
+        }
+        if (len - i > 1) {
+          const unsigned int n = (sextet[in[0]] << 18) | (sextet[in[1]] << 12) | (len - i > 2 ? sextet[in[2]] << 6 : 0);
+          *out++ = n >> 16;
+          if (len - i > 2) *out++ = n >> 8;
+        }
+        k_.resize(out - (unsigned char*)&k_[0]);
+        return k_;
       };
       static string oMd5(string k) {
         unsigned char digest[MD5_DIGEST_LENGTH];
-        MD5((unsigned char*)k.data(), k.length(), (unsigned char*)&digest);
-        char k_[16*2+1];
-        for (unsigned int i = 0; i < 16; i++) sprintf(&k_[i*2], "%02x", (unsigned int)digest[i]);
-        return strU(k_);
+        MD5((unsigned char*)k.data(), k.length(), digest);
+        return oHex(digest, MD5_DIGEST_LENGTH, true);
       };
       static string oSha256(string k) {
         unsigned char digest[SHA256_DIGEST_LENGTH];
-        SHA256((unsigned char*)k.data(), k.length(), (unsigned char*)&digest);
-        char k_[SHA256_DIGEST_LENGTH*2+1];
-        for (unsigned int i = 0; i < SHA256_DIGEST_LENGTH; i++) sprintf(&k_[i*2], "%02x", (unsigned int)digest[i]);
-        return k_;
+        SHA256((unsigned char*)k.data(), k.length(), digest);
+        return oHex(digest, SHA256_DIGEST_LENGTH);
       };
       static string oSha512(string k) {
         unsigned char digest[SHA512_DIGEST_LENGTH];
-        SHA512((unsigned char*)k.data(), k.length(), (unsigned char*)&digest);
-        char k_[SHA512_DIGEST_LENGTH*2+1];
-        for (unsigned int i = 0; i < SHA512_DIGEST_LENGTH; i++) sprintf(&k_[i*2], "%02x", (unsigned int)digest[i]);
-        return k_;
+        SHA512((unsigned char*)k.data(), k.length(), digest);
+        return oHex(digest, SHA512_DIGEST_LENGTH);
       };
       static string oHmac1(string p, string s, bool hex = false) {
-        unsigned char* digest;
-        digest = HMAC(EVP_sha1(), s.data(), s.length(), (unsigned char*)p.data(), p.length(), NULL, NULL);
-        char k_[SHA_DIGEST_LENGTH*2+1];
-        for (unsigned int i = 0; i < SHA_DIGEST_LENGTH; i++) sprintf(&k_[i*2], "%02x", (unsigned int)digest[i]);
-        return hex ? oHex(k_) : k_;
+        return oHmac(EVP_sha1(), p, s, hex);
       };
       static string oHmac256(string p, string s, bool hex = false) {
-        unsigned char* digest;
-        digest = HMAC(EVP_sha256(), s.data(), s.length(), (unsigned char*)p.data(), p.length(), NULL, NULL);
-        char k_[SHA256_DIGEST_LENGTH*2+1];
-        for (unsigned int i = 0; i < SHA256_DIGEST_LENGTH; i++) sprintf(&k_[i*2], "%02x", (unsigned int)digest[i]);
-        return hex ? oHex(k_) : k_;
+        return oHmac(EVP_sha256(), p, s, hex);
       };
       static string oHmac512(string p, string s, bool hex = false) {
-        unsigned char* digest;
-        digest = HMAC(EVP_sha512(), s.data(), s.length(), (unsigned char*)p.data(), p.length(), NULL, NULL);
-        char k_[SHA512_DIGEST_LENGTH*2+1];
-        for (unsigned int i = 0; i < SHA512_DIGEST_LENGTH; i++) sprintf(&k_[i*2], "%02x", (unsigned int)digest[i]);
-        return hex ? oHex(k_) : k_;
+        return oHmac(EVP_sha512(), p, s, hex);
       };
       static string oHmac384(string p, string s) {
-        unsigned char* digest;
-        digest = HMAC(EVP_sha384(), s.data(), s.length(), (unsigned char*)p.data(), p.length(), NULL, NULL);
-        char k_[SHA384_DIGEST_LENGTH*2+1];
-        for (unsigned int i = 0; i < SHA384_DIGEST_LENGTH; i++) sprintf(&k_[i*2], "%02x", (unsigned int)digest[i]);
-        return k_;
+        return oHmac(EVP_sha384(), p, s, false);
+      };
+    private:
+      static string oHmac(const EVP_MD *md, const string &p, const string &s, const bool &hex) {
+        static thread_local struct mSecrets {
+          unordered_map<const EVP_MD*, unordered_map<string, HMAC_CTX*>> ctx;
+          ~mSecrets() {
+            for (const unordered_map<const EVP_MD*, unordered_map<string, HMAC_CTX*>>::value_type &it : ctx)
+              for (const unordered_map<string, HMAC_CTX*>::value_type &_it : it.second)
+                HMAC_CTX_free(_it.second);
+          };
+        } secrets;
+        unsigned char fingerprint[SHA256_DIGEST_LENGTH];                     // never keep the plaintext secret around as a key
+        SHA256((unsigned char*)s.data(), s.length(), fingerprint);
+        HMAC_CTX *&ctx = secrets.ctx[md][string((char*)fingerprint, SHA256_DIGEST_LENGTH)];
+        if (ctx) HMAC_Init_ex(ctx, nullptr, 0, nullptr, nullptr);
+        else HMAC_Init_ex(ctx = HMAC_CTX_new(), s.data(), s.length(), md, nullptr);
+        unsigned char digest[EVP_MAX_MD_SIZE];
+        unsigned int len = 0;
+        HMAC_Update(ctx, (unsigned char*)p.data(), p.length());
+        HMAC_Final(ctx, digest, &len);
+        return hex
+          ? string((char*)digest, len)
+          : oHex(digest, len);
+      };
+  };
+
+  static class mTimeline {
+    public:
+      function<void()> wakeup;
+    private:
+      struct mTask {
+        mClock at,
+               every;
+        function<void()> fn;
+      };
+      static const unsigned int bits   = 6,
+                                slots  = 1 << bits,
+                                levels = 5;
+      vector<pair<unsigned long, mClock>> wheel[levels][slots];
+      unordered_map<unsigned long, mTask> tasks;
+      unsigned long lastId = 0;
+      mClock now      = Tstamp,
+             deadline = 0;
+    public:
+      const unsigned long after(const mClock &delay, const function<void()> &fn) {
+        return schedule(++lastId, {Tstamp + delay, 0, fn});
+      };
+      const unsigned long every(const mClock &interval, const function<void()> &fn) {
+        return every(interval, fn, interval);
+      };
+      const unsigned long every(const mClock &interval, const function<void()> &fn, const mClock &delay) {
+        return schedule(++lastId, {Tstamp + delay, interval ?: 1, fn});
+      };
+      void reset(const unsigned long &id, const mClock &delay) {
+        if (tasks.find(id) != tasks.end())
+          insert(id, tasks.at(id).at = max(Tstamp + delay, now + 1));
+      };
+      void cancel(const unsigned long &id) {
+        tasks.erase(id);
+      };
+      void advance(const mClock &until = Tstamp) {
+        if (tasks.empty()) now = max(now, until);
+        while (now < until) {
+          ++now;
+          for (unsigned int level = 1; level < levels; ++level) {
+            if (now & ((1ULL << (bits * level)) - 1)) break;
+            cascade(wheel[level][(now >> (bits * level)) & (slots - 1)]);
+          }
+          if (wheel[0][now & (slots - 1)].empty()) continue;
+          vector<pair<unsigned long, mClock>> due;
+          due.swap(wheel[0][now & (slots - 1)]);
+          for (const pair<unsigned long, mClock> &it : due) fire(it.first, it.second);
+        }
+      };
+      const mClock idle() {
+        mClock next = now + (1ULL << (bits * levels));
+        for (unsigned int level = 0; level < levels; ++level) {
+          const mClock block = now >> (bits * level);
+          for (unsigned int i = 1; i <= slots; ++i)
+            if (!wheel[level][(block + i) & (slots - 1)].empty()) {
+              next = min(next, (block + i) << (bits * level));
+              break;
+            }
+        }
+        deadline = next;
+        return next - min(next, clockwork.fresh());
+      };
+    private:
+      const unsigned long schedule(const unsigned long &id, const mTask &task) {
+        tasks[id] = task;
+        insert(id, tasks.at(id).at = max(task.at, now + 1));
+        return id;
+      };
+      void insert(const unsigned long &id, const mClock &at) {
+        const mClock delta = min(at - now, (1ULL << (bits * levels)) - 1);
+        unsigned int level = 0;
+        while (delta >> (bits * (level + 1))) ++level;
+        wheel[level][(at >> (bits * level)) & (slots - 1)].push_back({id, at});
+        if (at < deadline or !deadline) {
+          deadline = at;
+          if (wakeup) wakeup();
+        }
+      };
+      void cascade(vector<pair<unsigned long, mClock>> &slot) {
+        if (slot.empty()) return;
+        vector<pair<unsigned long, mClock>> due;
+        due.swap(slot);
+        for (const pair<unsigned long, mClock> &it : due)
+          if (it.second > now) insert(it.first, it.second);
+          else fire(it.first, it.second);
+      };
+      void fire(const unsigned long &id, const mClock &at) {
+        unordered_map<unsigned long, mTask>::iterator it = tasks.find(id);
+        if (it == tasks.end() or it->second.at != at) return;
+        const function<void()> fn = it->second.fn;
+        if (it->second.every)
+          insert(id, it->second.at = max(at + it->second.every, now + 1));
+        else tasks.erase(it);
+        fn();
+      };
+  } timeline;
+
+  static class mChores {
+    private:
+      deque<function<void()>> slices;
+      bool starved = false;
+    public:
+      static const size_t rows = 512;
+      void push(const vector<function<void()>> &job) {
+        slices.insert(slices.end(), job.begin(), job.end());
+      };
+      const bool run(const unsigned int &budget) {
+        const size_t before = slices.size();
+        while (!slices.empty() and (starved or clockwork.spent() < budget)) {
+          starved = false;
+          const function<void()> fn = slices.front();
+          slices.pop_front();
+          fn();
+        }
+        starved = !slices.empty() and slices.size() == before;
+        return !slices.empty();
+      };
+      const size_t size() const {
+        return slices.size();
+      };
+  } chores;
+
+  static class mTopology {
+    private:
+      struct mThread {
+           string role;
+        pthread_t id;
+             bool pinned   = false,
+                  realtime = false;
+      };
+      unordered_map<string, string> cpus;
+      unordered_map<string, int> priority;
+      vector<mThread> threads;
+      mutex lock;
+    public:
+      void pin(const string &role, const string &list) {
+        lock_guard<mutex> lock_(lock);
+        cpus[role] = list;
+      };
+      void fifo(const string &role, const int &level) {
+        lock_guard<mutex> lock_(lock);
+        priority[role] = level;
+      };
+      void join(const string &role) {
+        mThread k = {role, pthread_self()};
+        lock_guard<mutex> lock_(lock);
+#ifdef __linux__
+        pthread_setname_np(k.id, ("K-" + role).substr(0, 15).data());
+        const unordered_map<string, string>::const_iterator list = cpus.find(role);
+        cpu_set_t set;
+        if (list != cpus.end() and parse(list->second, set))
+          k.pinned = !pthread_setaffinity_np(k.id, sizeof(set), &set);
+        const unordered_map<string, int>::const_iterator level = priority.find(role);
+        if (level != priority.end() and level->second > 0) {
+          const sched_param param = {min(99, level->second)};
+          k.realtime = !pthread_setschedparam(k.id, SCHED_FIFO, &param);
+        }
+#endif
+        threads.push_back(k);
+      };
+      void leave() {
+        const pthread_t id = pthread_self();
+        lock_guard<mutex> lock_(lock);
+        threads.erase(remove_if(threads.begin(), threads.end(), [&](const mThread &it) {
+          return pthread_equal(it.id, id);
+        }), threads.end());
+      };
+      const json stats() {
+        json roles = json::object();
+        lock_guard<mutex> lock_(lock);
+        for (const mThread &it : threads) {
+          json &role = roles[it.role];
+          if (role.is_null()) role = json::object();
+          role["cpus"]     = cpus.find(it.role) == cpus.end() ? "" : cpus.at(it.role);
+          role["threads"]  = role.value("threads", 0) + 1;
+          role["cpu"]      = role.value("cpu", (mClock)0) + spent(it.id);
+          role["pinned"]   = role.value("pinned", true) and it.pinned;
+          role["realtime"] = role.value("realtime", true) and it.realtime;
+        }
+        return roles;
+      };
+    private:
+      static const mClock spent(const pthread_t &id) {
+#ifdef __linux__
+        clockid_t cid;
+        struct timespec ts;
+        if (!pthread_getcpuclockid(id, &cid) and !clock_gettime(cid, &ts))
+          return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+#endif
+        return 0;
+      };
+#ifdef __linux__
+      static const bool parse(const string &list, cpu_set_t &set) {
+        CPU_ZERO(&set);
+        if (list.empty()) return false;
+        stringstream ss(list);
+        string range;
+        while (getline(ss, range, ',')) {
+          const size_t dash = range.find('-');
+          const int first = atoi(range.data()),
+                    last  = dash == string::npos ? first : atoi(range.data() + dash + 1);
+          for (int cpu = max(0, first); cpu <= last and cpu < CPU_SETSIZE; ++cpu)
+            CPU_SET(cpu, &set);
+        }
+        return CPU_COUNT(&set);
+      };
+#endif
+  } topology;
+
+  template <typename T> class mQueue {
+    private:
+      struct mNode {
+        atomic<mNode*> next = {nullptr};
+        T value;
+      };
+      atomic<mNode*> head;
+      mNode *tail;
+    public:
+      mQueue()
+        : head(new mNode())
+        , tail(head.load())
+      {};
+      ~mQueue() {
+        T value;
+        while (pop(value));
+        delete tail;
+      };
+      void push(const T &value) {
+        mNode *const node = new mNode();
+        node->value = value;
+        head.exchange(node, memory_order_acq_rel)->next.store(node, memory_order_release);
+      };
+      const bool pop(T &value) {
+        mNode *const next = tail->next.load(memory_order_acquire);
+        if (!next) return false;
+        value = move(next->value);
+        delete tail;
+        tail = next;
+        return true;
+      };
+  };
+
+  class mWorkers {
+    public:
+      function<void()> wakeup;
+    private:
+      vector<thread> threads;
+      deque<function<void()>> jobs;
+      mQueue<function<void()>> replies;
+      mutex lock;
+      condition_variable ready;
+      size_t depth = 0;
+      bool stopped = false;
+    public:
+      ~mWorkers() {
+        stop();
+      };
+      void start(const unsigned int &size, const size_t &queue) {
+        depth = max((size_t)1, queue);
+        for (unsigned int i = 0; i < max(1U, size); ++i)
+          threads.push_back(thread([&]() {
+            topology.join("gateway");
+            for (;;) {
+              function<void()> job;
+              {
+                unique_lock<mutex> lock_(lock);
+                ready.wait(lock_, [&]() { return stopped or !jobs.empty(); });
+                if (jobs.empty()) break;
+                job = jobs.front();
+                jobs.pop_front();
+              }
+              job();
+            }
+            topology.leave();
+          }));
+      };
+      void stop() {
+        {
+          lock_guard<mutex> lock_(lock);
+          stopped = true;
+        }
+        ready.notify_all();
+        for (thread &it : threads) it.join();
+        threads.clear();
+      };
+      const bool push(const function<void()> &job) {
+        {
+          lock_guard<mutex> lock_(lock);
+          if (stopped or threads.empty() or jobs.size() >= depth)
+            return false;
+          jobs.push_back(job);
+        }
+        ready.notify_one();
+        return true;
+      };
+      void reply(const function<void()> &fn) {
+        replies.push(fn);
+        if (wakeup) wakeup();
+      };
+      const bool drain() {
+        bool delivered = false;
+        function<void()> fn;
+        while (replies.pop(fn)) {
+          fn();
+          delivered = true;
+        }
+        return delivered;
+      };
+  };
+
+  class mJournal {
+    public:
+      function<void(const vector<function<void()>>&)> commit;
+    private:
+      thread writer;
+      vector<function<void()>> writes;
+      mHistogram latency;
+      mutex lock;
+      condition_variable ready,
+                         room;
+             mClock interval = 50;
+             size_t depth    = 4096,
+                    deepest  = 0;
+      unsigned long commits  = 0,
+                    rows     = 0,
+                    stalls   = 0;
+               bool stopped  = true;
+    public:
+      ~mJournal() {
+        stop();
+      };
+      void start(const mClock &every, const size_t &queue) {
+        interval = every;
+        depth = max((size_t)1, queue);
+        stopped = false;
+        writer = thread([&]() {
+          topology.join("db");
+          for (;;) {
+            vector<function<void()>> batch;
+            {
+              unique_lock<mutex> lock_(lock);
+              ready.wait(lock_, [&]() { return stopped or !writes.empty(); });
+              if (writes.empty()) break;
+              ready.wait_for(lock_, chrono::milliseconds(interval), [&]() {
+                return stopped or writes.size() >= depth;
+              });
+              batch.swap(writes);
+            }
+            room.notify_all();
+            flush(batch);
+          }
+          topology.leave();
+        });
+      };
+      void stop() {
+        {
+          lock_guard<mutex> lock_(lock);
+          stopped = true;
+        }
+        ready.notify_all();
+        room.notify_all();
+        if (writer.joinable()) writer.join();
+      };
+      void push(const function<void()> &write) {
+        if (!write) return;
+        {
+          unique_lock<mutex> lock_(lock);
+          if (!stopped) {
+            if (writes.size() >= depth) {
+              stalls++;
+              ready.notify_one();
+              room.wait(lock_, [&]() { return stopped or writes.size() < depth; });
+            }
+            if (!stopped) {
+              writes.push_back(write);
+              deepest = max(deepest, writes.size());
+              if (writes.size() == 1) ready.notify_one();
+              return;
+            }
+          }
+        }
+        flush({write});
+      };
+      const json stats() {
+        lock_guard<mutex> lock_(lock);
+        return {
+          {  "queue", writes.size()  },
+          {"deepest", deepest        },
+          {"commits", commits        },
+          {   "rows", rows           },
+          { "stalls", stalls         },
+          { "commit", latency.stats()}
+        };
+      };
+    private:
+      void flush(const vector<function<void()>> &batch) {
+        const mClock began = Tsteady;
+        if (commit) commit(batch);
+        const mClock spent = Tsteady - began;
+        lock_guard<mutex> lock_(lock);
+        latency.record(spent);
+        commits++;
+        rows += batch.size();
+      };
+  };
+
+  class mPublisher {
+    private:
+      thread worker;
+      mQueue<function<void()>> jobs;
+      atomic<size_t> pending = {0};
+      atomic<unsigned long long> published = {0};
+      mutex lock;
+      condition_variable ready;
+      bool stopped = true;
+    public:
+      ~mPublisher() {
+        stop();
+      };
+      void start(const string &role) {
+        stopped = false;
+        worker = thread([&, role]() {
+          topology.join(role);
+          function<void()> job;
+          for (;;) {
+            while (jobs.pop(job)) {
+              job();
+              published++;
+              pending--;
+            }
+            unique_lock<mutex> lock_(lock);
+            if (stopped and !pending) break;
+            ready.wait(lock_, [&]() { return stopped or pending; });
+          }
+          topology.leave();
+        });
+      };
+      void stop() {
+        {
+          lock_guard<mutex> lock_(lock);
+          stopped = true;
+        }
+        ready.notify_all();
+        if (worker.joinable()) worker.join();
+      };
+      void push(const function<void()> &job) {
+        if (!worker.joinable()) {
+          job();
+          published++;
+          return;
+        }
+        jobs.push(job);
+        if (!pending++) {
+          lock_guard<mutex> lock_(lock);
+          ready.notify_one();
+        }
+      };
+      const json stats() const {
+        return {
+          {  "pending", pending.load()  },
+          {"published", published.load()}
+        };
+      };
+  };
+
+  class mBudget {
+    private:
+      struct mEndpoint {
+               mClock base      = 0,
+                      every     = 0;
+               double weight    = 1;
+        unsigned long granted   = 0,
+                      throttled = 0;
+      };
+      unordered_map<string, mEndpoint> endpoints;
+      double rate   = 10,
+             burst  = 20,
+             tokens = 20;
+      mClock last   = 0;
+    public:
+      void limit(const double &r, const double &b) {
+        rate   = r;
+        tokens = burst = b;
+        last   = Tstamp;
+      };
+      void weight(const string &endpoint, const double &w) {
+        endpoints[endpoint].weight = w;
+      };
+      const bool take(const string &endpoint, const bool &priority = false) {
+        mEndpoint &k = endpoints[endpoint];
+        if (!allowed(k, priority)) {
+          k.throttled++;
+          return false;
+        }
+        spend(k);
+        return true;
+      };
+      void every(const string &endpoint, const mClock &interval, const function<bool()> &fn) {
+        endpoints[endpoint].base = endpoints[endpoint].every = interval;
+        timeline.after(0, [this, endpoint, fn]() { poll(endpoint, fn); });
+      };
+      const json stats() {
+        refill();
+        json polls = json::object();
+        for (const unordered_map<string, mEndpoint>::value_type &it : endpoints)
+          polls[it.first] = {
+            {    "every", it.second.every    },
+            {  "granted", it.second.granted  },
+            {"throttled", it.second.throttled}
+          };
+        return {
+          {   "rate", rate          },
+          {  "burst", burst         },
+          { "tokens", floor(tokens) },
+          {"endpoints", polls       }
+        };
+      };
+    private:
+      void refill() {
+        const mClock now = Tstamp;
+        tokens = fmin(burst, tokens + rate * (now - last) / 1e+3);
+        last = now;
+      };
+      const bool allowed(const mEndpoint &k, const bool &priority) {
+        refill();
+        return priority or tokens - k.weight >= burst / 4;
+      };
+      void spend(mEndpoint &k) {
+        tokens = fmax(-burst, tokens - k.weight);
+        k.granted++;
+      };
+      void poll(const string &endpoint, const function<bool()> &fn) {
+        mEndpoint &k = endpoints[endpoint];
+        if (!allowed(k, false)) {
+          k.throttled++;
+          k.every = min(k.base * 8, k.every * 2);
+        } else if (fn()) {
+          spend(k);
+          k.every = max(k.base, k.every / 2);
+        }
+        timeline.after(k.every, [this, endpoint, fn]() { poll(endpoint, fn); });
+      };
+  };
+
+  class mFailover {
+    private:
+            mClock since = 0,
+                   last  = 0,
+                   worst = 0,
+                   total = 0;
+      unsigned int drops = 0,
+                   gaps  = 0;
+    public:
+      const bool down() {
+        drops++;
+        if (since) return false;
+        since = Tstamp;
+        return true;
+      };
+      const bool up() {
+        if (!since) return false;
+        last = Tstamp - since;
+        worst = max(worst, last);
+        total += last;
+        gaps++;
+        since = 0;
+        return true;
+      };
+      const mClock gap() const {
+        return last;
+      };
+      const json stats() const {
+        return {
+          {"drops", drops                   },
+          { "last", last                    },
+          {"worst", worst                   },
+          { "mean", gaps ? total / gaps : 0 }
+        };
+      };
+  };
+
+  class mLifecycle {
+    private:
+      mHistogram queue,
+                 gateway,
+                 ack,
+                 fill,
+                 cancel;
+      json window = json::object();
+    public:
+      void decided(mOrder *const order) {
+        if (!order) return;
+        vector<mClock> filled = move(order->stamps.filled);
+        order->stamps = mOrder::mStamps();
+        order->stamps.decided = Tsteady;
+        order->stamps.filled  = move(filled);
+      };
+      void handed(const vector<mOrder*> &orders) {
+        const mClock now = Tsteady;
+        for (mOrder *const it : orders) {
+          it->stamps.handed = now;
+          if (it->stamps.decided) queue.record(now - it->stamps.decided);
+        }
+      };
+      void withdrawn(const vector<mOrder*> &orders) {
+        const mClock now = Tsteady;
+        for (mOrder *const it : orders) it->stamps.withdrawn = now;
+      };
+      void sent(mOrder *const order) {                                       // only from gateways that know when the request leaves
+        mOrder::mStamps &k = order->stamps;
+        k.sent = Tsteady;
+        if (k.handed) gateway.record(k.sent - k.handed);
+      };
+      void canceled(mOrder *const order) {
+        mOrder::mStamps &k = order->stamps;
+        k.canceled = Tsteady;
+        if (!k.withdrawn) k.withdrawn = k.canceled;
+      };
+      void read(const mOrder &raw, mOrder *const order) {
+        if (!order) return;
+        mOrder::mStamps &k = order->stamps;
+        const mClock now  = Tsteady,
+                     from = k.sent ?: k.handed;
+        if (raw.status == mStatus::Working and !k.acked) {
+          k.acked = now;
+          if (from) ack.record(now - from);
+        }
+        if (raw.tradeQuantity) {
+          k.filled.push_back(now);
+          if (from) fill.record(now - from);
+        }
+        if (raw.status == mStatus::Terminated and !k.closed) {
+          k.closed = now;
+          if (k.withdrawn) cancel.record(now - k.withdrawn);
+        }
+      };
+      void roll() {
+        window = stats();
+        for (mHistogram *const it : {&queue, &gateway, &ack, &fill, &cancel})
+          it->clear();
+      };
+      const json last() const {
+        return window;
+      };
+      const json stats() const {
+        return {
+          {  "queue", queue.stats()  },
+          {"gateway", gateway.stats()},
+          {    "ack", ack.stats()    },
+          {   "fill", fill.stats()   },
+          { "cancel", cancel.stats() }
+        };
+      };
+  };
+
+  class mFix {
+    public:
+      struct mReport {
+        string_view type,
+                    clOrdId,
+                    origClOrdId,
+                    orderId,
+                    ordStatus,
+                    side,
+                    price,
+                    orderQty,
+                    lastPx,
+                    lastShares,
+                    text;
+        const mOrder order() const {
+          const char status = ordStatus.empty() ? '0' : ordStatus[0];
+          mOrder k(
+            string(clOrdId),
+            string(orderId),
+            status == '0' or status == '1' or status == '5' or status == '6' or status == 'A' or status == 'E'
+              ? mStatus::Working
+              : mStatus::Terminated,
+            strD(string(lastShares.empty() ? price : lastPx).data()),
+            strD(string(orderQty).data()),
+            strD(string(lastShares).data())
+          );
+          if (!side.empty()) k.side = side[0] == '1' ? mSide::Bid : mSide::Ask;
+          return k;
+        };
+      };
+      mFix(const string &sender, const string &target, const string &symbol)
+      {
+        const string header = "\x01" "49=" + sender + "\x01" "56=" + target + "\x01" "34=";
+        for (const char &type : string("A01DF5"))
+          prefix[type] = "35=" + string(1, type) + header;
+        instrument = "\x01" "55=" + symbol;
+      };
+      ~mFix() {
+        close();
+      };
+      const bool logon(const unsigned int &heartbeat, const vector<pair<unsigned int, string>> &fields = {}) {
+        lock_guard<mutex> lock(io);
+        begin('A');
+        field(98, "0");
+        field(108, to_string(heartbeat));
+        for (const pair<unsigned int, string> &it : fields)
+          field(it.first, it.second);
+        return write(end());
+      };
+      const bool heartbeat(const string_view &testReqId = "") {
+        lock_guard<mutex> lock(io);
+        begin('0');
+        if (!testReqId.empty()) field(112, testReqId);
+        return write(end());
+      };
+      const bool logout() {
+        lock_guard<mutex> lock(io);
+        begin('5');
+        return write(end());
+      };
+      const bool order(const mRandId &clOrdId, const mSide &side, const string_view &price, const string_view &qty, const mOrderType &type, const mTimeInForce &tif, const bool &postOnly) {
+        lock_guard<mutex> lock(io);
+        begin('D');
+        field(21, "1");
+        field(11, clOrdId);
+        buffer += instrument;
+        field(54, side == mSide::Bid ? "1" : "2");
+        field(38, qty);
+        if (type == mOrderType::Limit) {
+          field(40, "2");
+          field(44, price);
+          field(59, tif == mTimeInForce::GTC ? "1" : (tif == mTimeInForce::FOK ? "4" : "3"));
+          if (postOnly) field(18, "6");
+        } else field(40, "1");
+        return write(end());
+      };
+      const bool cancel(const mRandId &origClOrdId, const mRandId &orderId, const mRandId &clOrdId) {
+        lock_guard<mutex> lock(io);
+        begin('F');
+        field(41, origClOrdId);
+        if (!orderId.empty()) field(37, orderId);
+        field(11, clOrdId);
+        buffer += instrument;
+        return write(end());
+      };
+      const string_view message() const {
+        return composed;
+      };
+      static const size_t frame(const string_view &data) {
+        if (data.length() < 16 or data.compare(0, 2, "8=")) return 0;
+        const size_t length = data.find("\x01" "9=");
+        if (length == string_view::npos) return 0;
+        const size_t body = data.find('\x01', length + 3);
+        if (body == string_view::npos) return 0;
+        const size_t total = body + 1 + strtoul(data.data() + length + 3, nullptr, 10) + 7;
+        return total <= data.length() ? total : 0;
+      };
+      static const bool oversized(const string_view &data) {
+        if (data.length() > limit) return true;
+        const size_t length = data.find("\x01" "9=");
+        return length != string_view::npos
+          and data.find('\x01', length + 3) != string_view::npos
+          and strtoul(data.data() + length + 3, nullptr, 10) > limit;
+      };
+      static const bool parse(const string_view &msg, mReport &report) {
+        report = mReport();
+        unsigned int sum = 0;
+        size_t a = 0;
+        while (a < msg.length()) {
+          const size_t eq = msg.find('=', a),
+                       soh = msg.find('\x01', a);
+          if (eq == string_view::npos or soh == string_view::npos or eq > soh) return false;
+          unsigned int tag = 0;
+          for (size_t i = a; i < eq; ++i) tag = tag * 10 + (msg[i] - '0');
+          const string_view value = msg.substr(eq + 1, soh - eq - 1);
+          if (tag == 10)
+            return (sum & 255) == strtoul(string(value).data(), nullptr, 10);
+          for (size_t i = a; i <= soh; ++i) sum += (unsigned char)msg[i];
+          switch (tag) {
+            case  35: report.type        = value; break;
+            case  11: report.clOrdId     = value; break;
+            case  41: report.origClOrdId = value; break;
+            case  37: report.orderId     = value; break;
+            case  39: report.ordStatus   = value; break;
+            case  54: report.side        = value; break;
+            case  44: report.price       = value; break;
+            case  38: report.orderQty    = value; break;
+            case  31: report.lastPx      = value; break;
+            case  32: report.lastShares  = value; break;
+            case  58: report.text        = value; break;
+            case 112: if (report.type == "1") report.text = value; break;
+          }
+          a = soh + 1;
+        }
+        return false;
+      };
+      const bool connect(const string &endpoint, const unsigned int &heartbeat, const vector<pair<unsigned int, string>> &fields, const function<void(const mReport&)> &read) {
+        close();
+        if (!(ctx = SSL_CTX_new(TLS_client_method()))) return false;
+        SSL_CTX_set_default_verify_paths(ctx);
+        SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, nullptr);
+        if (!(bio = BIO_new_ssl_connect(ctx))) return false;
+        SSL *ssl = nullptr;
+        BIO_get_ssl(bio, &ssl);
+        SSL_set_mode(ssl, SSL_MODE_AUTO_RETRY);
+        SSL_set_tlsext_host_name(ssl, endpoint.substr(0, endpoint.find(':')).data());
+        BIO_set_conn_hostname(bio, endpoint.data());
+        if (BIO_do_connect(bio) <= 0 or BIO_do_handshake(bio) <= 0) {
+          close();
+          return false;
+        }
+        int fd = -1;
+        if (BIO_get_fd(bio, &fd) < 0 or !BIO_socket_nbio(fd, 1)) {
+          close();
+          return false;
+        }
+        seq = 0;
+        every = heartbeat * 1e+3;
+        session = logon(heartbeat, fields);
+        if (session) reader = thread([this, read]() {
+          topology.join("gateway");
+          listen(read);
+          topology.leave();
+        });
+        return session;
+      };
+      void close() {
+        if (session) {
+          logout();
+          session = false;
+        }
+        if (reader.joinable()) reader.join();
+        lock_guard<mutex> lock(io);
+        if (bio) BIO_free_all(bio);
+        if (ctx) SSL_CTX_free(ctx);
+        bio = nullptr;
+        ctx = nullptr;
+      };
+    private:
+      map<char, string> prefix;
+      string instrument;
+      string buffer;
+      unsigned long seq = 0;
+      mClock every = 30e+3,
+             stamp = 0;
+      atomic<mClock> last = {0};
+      char stampBuffer[18];
+      SSL_CTX *ctx = nullptr;
+      BIO *bio = nullptr;
+      string_view composed;
+      mutex io;
+      thread reader;
+      atomic<bool> session = {false};
+      static const size_t room  = 24,
+                          limit = 1 << 20;
+      void begin(const char &type) {
+        buffer.assign(room, '\0');
+        buffer += prefix[type];
+        buffer += to_string(++seq);
+        buffer += "\x01" "52=";
+        buffer += now();
+      };
+      const string_view end() {
+        buffer += '\x01';
+        const string length = to_string(buffer.length() - room);
+        const size_t head = room - 13 - length.length();
+        buffer.replace(head, 13 + length.length(), "8=FIX.4.2\x01" "9=" + length + "\x01");
+        unsigned int sum = 0;
+        for (size_t i = head; i < buffer.length(); ++i) sum += (unsigned char)buffer[i];
+        buffer += "10=";
+        buffer += (char)('0' + (sum & 255) / 100);
+        buffer += (char)('0' + (sum & 255) / 10 % 10);
+        buffer += (char)('0' + (sum & 255) % 10);
+        buffer += '\x01';
+        return composed = string_view(buffer.data() + head, buffer.length() - head);
+      };
+      const bool write(const string_view &msg) {
+        if (!bio) return false;
+        size_t sent = 0;
+        while (sent < msg.length()) {
+          const int n = BIO_write(bio, msg.data() + sent, msg.length() - sent);
+          if (n > 0) sent += n;
+          else if (!BIO_should_retry(bio)) return false;
+          else wait(false);
+        }
+        last = Tstamp;
+        return true;
+      };
+      void field(const unsigned int &tag, const string_view &value) {
+        buffer += '\x01';
+        buffer += to_string(tag);
+        buffer += '=';
+        buffer += value;
+      };
+      const string_view now() {
+        const mClock ms = Tstamp;
+        if (ms / 1000 != stamp) {
+          stamp = ms / 1000;
+          const time_t t = stamp;
+          struct tm tm;
+          gmtime_r(&t, &tm);
+          strftime(stampBuffer, sizeof(stampBuffer), "%Y%m%d-%H:%M:%S", &tm);
+        }
+        static thread_local char k[22];
+        memcpy(k, stampBuffer, 17);
+        k[17] = '.';
+        k[18] = '0' + ms % 1000 / 100;
+        k[19] = '0' + ms % 100 / 10;
+        k[20] = '0' + ms % 10;
+        return string_view(k, 21);
+      };
+      void wait(const bool &readable) {
+        int fd = -1;
+        BIO_get_fd(bio, &fd);
+        fd_set set;
+        FD_ZERO(&set);
+        FD_SET(fd, &set);
+        struct timeval tv = {0, 100000};
+        select(fd + 1, readable ? &set : nullptr, readable ? nullptr : &set, nullptr, &tv);
+      };
+      void listen(const function<void(const mReport&)> &read) {
+        string data;
+        char chunk[4096];
+        mReport report;
+        while (session) {
+          int n;
+          {
+            // one SSL object may not read and write at once, but this read never blocks
+            lock_guard<mutex> lock(io);
+            n = BIO_read(bio, chunk, sizeof(chunk));
+            if (n <= 0 and !BIO_should_retry(bio)) break;
+          }
+          if (n > 0) {
+            data.append(chunk, n);
+            if (oversized(data))
+              data.erase(0, data.find("8=FIX", 1));
+            size_t len;
+            while ((len = frame(data))) {
+              if (parse(string_view(data.data(), len), report)) {
+                if (report.type == "1") heartbeat(report.text);
+                else if (report.type != "0") read(report);
+              }
+              data.erase(0, len);
+            }
+            if (data.length() > 1 and data.compare(0, 2, "8="))
+              data.erase(0, data.find("8=FIX"));
+          } else {
+            if (Tstamp - last > every) heartbeat();
+            wait(true);
+          }
+        }
+        if (session) {
+          session = false;
+          report = mReport();
+          report.type = "5";
+          read(report);
+        }
       };
   };
 
@@ -509,36 +2109,64 @@ namespace K {
       function<void(const mLevels&)>       write_mLevels;
       function<void(const mWallets&)>      write_mWallets;
       function<void(const mConnectivity&)> write_mConnectivity;
-#define RAWDATA_ENTRY_POINT(mData, read) write_##mData = [&](const mData &rawdata) read
+#define RAWDATA_ENTRY_POINT(mData, read) write_##mData = [&](const mData &rawdata) { const mTurn turn; [&]() read (); }
       bool askForFees    = false,
            askForReplace = false;
       const bool *askForCancelAll = nullptr;
       const mRandId (*randId)() = nullptr;
-      virtual const bool askForData(const unsigned int &tick) = 0;
-      virtual const bool waitForData() = 0;
-      void place(const mOrder *const order) {
+      mClock askForOrdersEvery    =   2e+3,
+             askForLevelsEvery    =   3e+3,
+             askForWalletEvery    =  15e+3,
+             askForTradesEvery    =  60e+3,
+             askForCancelAllEvery = 300e+3;
+      mWorkers workers;
+      mBudget budget;
+      mLifecycle lifecycle;
+      unsigned int priceDecimals  = 8,
+                   amountDecimals = 8;
+      virtual void askForData() = 0;
+      const bool waitForData() {
+        return workers.drain();
+      };
+      const bool askForWallet() {
+        return !replyWallets and (async_wallet() or askFor(replyWallets, [&]() { return sync_wallet(); }, write_mWallets));
+      };
+      void place(mOrder *const order) {
+        char price[352],
+             quantity[352];
+        budget.take("place", true);
         place(
           order->orderId,
           order->side,
-          str8(order->price),
-          str8(order->quantity),
+          string(price, strX(price, order->price, priceDecimals, true)),
+          string(quantity, strX(quantity, order->quantity, amountDecimals, true)),
           order->type,
           order->timeInForce,
           order->preferPostOnly
         );
       };
-      void replace(const mOrder *const order) {
+      void replace(mOrder *const order) {
+        char price[352];
+        budget.take("replace", true);
         replace(
           order->exchangeId,
-          str8(order->price)
+          string(price, strX(price, order->price, priceDecimals, true))
         );
       };
-      void cancel(const mOrder *const order) {
+      void cancel(mOrder *const order) {
+        budget.take("cancel", true);
+        lifecycle.canceled(order);
         cancel(
           order->orderId,
           order->exchangeId
         );
       };
+      virtual void place_batch(const vector<mOrder*> &orders) {              // place many orders at once, natively if the exchange allows
+        for (mOrder *const it : orders) place(it);
+      };
+      virtual void cancel_batch(const vector<mOrder*> &orders) {             // cancel many orders at once, natively if the exchange allows
+        for (mOrder *const it : orders) cancel(it);
+      };
 //BO non-free gw library functions from build-*/local/lib/K-*.a (it just redefines all virtual gateway class members below).
 /**/  virtual bool ready() = 0;                                              // wait for exchange and register data handlers
 /**/  virtual void replace(mRandId, string) {};                              // call         async orders data from exchange
@@ -553,59 +2181,48 @@ namespace K {
 /**/  virtual vector<mOrder>   sync_orders()  { return {}; };                // call and read sync orders data from exchange
 /**/  virtual vector<mOrder>   sync_cancelAll() = 0;                         // call and read sync orders data from exchange
 //EO non-free gw library functions from build-*/local/lib/K-*.a (it just redefines all virtual gateway class members above).
-      future<vector<mWallets>> replyWallets;
-      future<vector<mLevels>> replyLevels;
-      future<vector<mTrade>> replyTrades;
-      future<vector<mOrder>> replyOrders;
-      future<vector<mOrder>> replyCancelAll;
-      const bool askForNeverAsyncData(const unsigned int &tick) {
-        bool waiting = false;
-        if (TRUEONCE(askForFees)
-          or !(tick % 15))       waiting |= !(async_wallet() or !askFor(replyWallets, [&]() { return sync_wallet(); }));
-        if (askForCancelAll
-          and *askForCancelAll
-          and !(tick % 300))     waiting |= askFor(replyCancelAll, [&]() { return sync_cancelAll(); });
-        return waiting;
-      };
-      const bool askForSyncData(const unsigned int &tick) {
-        bool waiting = false;
-        if (!(tick % 2))         waiting |= askFor(replyOrders, [&]() { return sync_orders(); });
-                                 waiting |= askForNeverAsyncData(tick);
-        if (!(tick % 3))         waiting |= askFor(replyLevels, [&]() { return sync_levels(); });
-        if (!(tick % 60))        waiting |= askFor(replyTrades, [&]() { return sync_trades(); });
-        return waiting;
-      };
-      const bool waitForNeverAsyncData() {
-        return waitFor(replyWallets,   write_mWallets)
-             | waitFor(replyCancelAll, write_mOrder);
-      };
-      const bool waitForSyncData() {
-        return waitFor(replyOrders,    write_mOrder)
-             | waitForNeverAsyncData()
-             | waitFor(replyLevels,    write_mLevels)
-             | waitFor(replyTrades,    write_mTrade);
+      virtual bool async_levels() { return false; };                         // call and read async levels data from exchange
+      virtual bool async_trades() { return false; };                         // call and read async trades data from exchange
+      virtual bool async_orders() { return false; };                         // call and read async orders data from exchange
+      bool replyWallets   = false,
+           replyLevels    = false,
+           replyTrades    = false,
+           replyOrders    = false,
+           replyCancelAll = false;
+      void askForNeverAsyncData() {
+        budget.every("wallet", askForWalletEvery, [&]() {
+          return askForWallet();
+        });
+        budget.every("cancelAll", askForCancelAllEvery, [&]() {
+          return askForCancelAll and *askForCancelAll
+            and askFor(replyCancelAll, [&]() { return sync_cancelAll(); }, write_mOrder);
+        });
       };
-      template<typename mData, typename syncFn> const bool askFor(
-              future<vector<mData>> &reply,
-        const syncFn                &read
-      ) {
-        bool waiting = reply.valid();
-        if (!waiting) {
-          reply = ::async(launch::async, read);
-          waiting = true;
-        }
-        return waiting;
+      void askForSyncData() {
+        budget.every("orders", askForOrdersEvery, [&]() {
+          return !replyOrders and (async_orders() or askFor(replyOrders, [&]() { return sync_orders(); }, write_mOrder));
+        });
+        askForNeverAsyncData();
+        budget.every("levels", askForLevelsEvery, [&]() {
+          return !replyLevels and (async_levels() or askFor(replyLevels, [&]() { return sync_levels(); }, write_mLevels));
+        });
+        budget.every("trades", askForTradesEvery, [&]() {
+          return !replyTrades and (async_trades() or askFor(replyTrades, [&]() { return sync_trades(); }, write_mTrade));
+        });
       };
-      template<typename mData> const unsigned int waitFor(
-              future<vector<mData>>        &reply,
+      template<typename mData, typename syncFn> const bool askFor(
+              bool                         &reply,
+        const syncFn                       &read,
         const function<void(const mData&)> &write
       ) {
-        bool waiting = reply.valid();
-        if (waiting and reply.wait_for(chrono::nanoseconds(0)) == future_status::ready) {
-          for (mData &it : reply.get()) write(it);
-          waiting = false;
-        }
-        return waiting;
+        if (reply) return false;
+        return reply = workers.push([&, read]() {
+          const vector<mData> data = read();
+          workers.reply([&, data]() {
+            reply = false;
+            for (const mData &it : data) write(it);
+          });
+        });
       };
   };
 
@@ -617,7 +2234,8 @@ namespace K {
                 apikey,   secret,
                 user,     pass,
                 http,     ws,
-                fix,      unlock;
+                fix,      standby,
+                unlock;
         mCoinId base,     quote;
             int version  = 0,
                 maxLevel = 0,
@@ -626,7 +2244,11 @@ namespace K {
         mAmount minSize  = 0,
                 makeFee  = 0,
                 takeFee  = 0;
+      mFailover failover;
       virtual const json handshake() = 0;
+      virtual const mClock cycle() {                                         // measure one place/ack/cancel/ack round trip in microseconds
+        return 0;
+      };
       void connect() {
         socket->connect(ws, nullptr, {}, 5e+3, &socket->getDefaultGroup<uWS::CLIENT>());
       };
@@ -634,6 +2256,7 @@ namespace K {
         socket->run();
       };
       void end(const bool &dustybot = false) {
+        workers.stop();
         if (dustybot)
           log("--dustybot is enabled, remember to cancel manually any open order.");
         else if (write_mOrder) {
@@ -644,7 +2267,9 @@ namespace K {
       };
       void info(vector<pair<string, string>> notes) {
         if (exchange != "NULL") log("allows client IP");
-        unsigned int precision = minTick < 1e-8 ? 10 : 8;
+        priceDecimals  = max(8u, decimals(minTick));
+        amountDecimals = max(8u, decimals(minSize));
+        unsigned int precision = max(priceDecimals, amountDecimals);
         for (pair<string, string> it : (vector<pair<string, string>>){
           {"symbols", symbol                  },
           {"minTick", strX(minTick, precision)},
@@ -654,29 +2279,90 @@ namespace K {
         }) notes.push_back(it);
         string info = "setup:";
         for (pair<string, string> &it : notes)
-          if (it.first != "gateway" or !it.second.empty())
+          if ((it.first != "gateway" and it.first != "standby") or !it.second.empty())
             info += "\n- " + it.first + ": " + it.second;
         log(info);
       };
-      void latency(const string &reason, const function<void()> &fn) {
+      void latency(const unsigned int &samples, const string &report, const function<void()> &handshake) {
         log("latency check", "start");
-        const mClock Tstart = Tstamp;
-        fn();
-        const mClock Tstop  = Tstamp;
+        const mClock Tstart = clockwork.fresh();
+        handshake();
+        const mClock Tstop  = clockwork.fresh();
         log("latency check", "stop");
         const unsigned int Tdiff = Tstop - Tstart;
-        log(reason + " took", to_string(Tdiff) + "ms of your time");
+        log("HTTP read/write handshake took", to_string(Tdiff) + "ms of your time");
+        mHistogram dns, tcp, tls, server, rest, wss, cycles;
+        for (unsigned int i = 0; i < samples; ++i) {
+          const mREST::mTiming k = mREST::probe(http);
+          if (!k.total) continue;
+          if (k.connects) {
+            dns.record(k.dns);
+            tcp.record(k.tcp);
+            tls.record(k.tls);
+          }
+          server.record(k.server);
+          rest.record(k.total);
+        }
+        if (ws.find("wss://") == 0)
+          for (unsigned int i = 0; i < samples; ++i) {
+            const mREST::mTiming k = mREST::probe("https://" + ws.substr(6), true);
+            if (k.total) wss.record(k.total);
+          }
+        for (unsigned int i = 0; i < samples; ++i) {
+          const mClock k = cycle();
+          if (!k) break;
+          cycles.record(k);
+        }
+        const json results = {
+          {"samples", samples},
+          {"handshake", Tdiff},
+          {"rest", {
+            { "total", rest.stats()  },
+            {   "dns", dns.stats()   },
+            {   "tcp", tcp.stats()   },
+            {   "tls", tls.stats()   },
+            {"server", server.stats()}
+          }},
+          {"wss", wss.stats()},
+          {"cycle", cycles.stats()}
+        };
+        for (const pair<string, const mHistogram*> &it : (vector<pair<string, const mHistogram*>>){
+          {"HTTP round trip",                &rest  },
+          {"HTTP DNS lookup",                &dns   },
+          {"HTTP TCP connect",               &tcp   },
+          {"HTTP TLS handshake",             &tls   },
+          {"HTTP server time",               &server},
+          {"WSS TCP/TLS connect",            &wss   },
+          {"order place/ack/cancel/ack",     &cycles}
+        }) if (it.second->count()) log(it.first + " min/p50/p90/p99/max",
+          strX(it.second->percentile(0) / 1e+3, 3) + "/"
+          + strX(it.second->percentile(50) / 1e+3, 3) + "/"
+          + strX(it.second->percentile(90) / 1e+3, 3) + "/"
+          + strX(it.second->percentile(99) / 1e+3, 3) + "/"
+          + strX(it.second->percentile(100) / 1e+3, 3) + "ms over "
+          + to_string(it.second->count()) + " samples"
+        );
+        const double typical = rest.count() ? rest.percentile(50) / 1e+3 : Tdiff;
         string result = "This result is ";
-        if      (Tdiff < 2e+2) result += "very good; most traders don't enjoy such speed!";
-        else if (Tdiff < 5e+2) result += "good; most traders get the same result";
-        else if (Tdiff < 7e+2) result += "a bit bad; most traders get better results";
-        else if (Tdiff < 1e+3) result += "bad; is possible a move to another server/network?";
-        else                   result += "very bad; move to another server/network";
+        if      (typical < 2e+2) result += "very good; most traders don't enjoy such speed!";
+        else if (typical < 5e+2) result += "good; most traders get the same result";
+        else if (typical < 7e+2) result += "a bit bad; most traders get better results";
+        else if (typical < 1e+3) result += "bad; is possible a move to another server/network?";
+        else                     result += "very bad; move to another server/network";
         log(result);
+        if (report.empty()) return;
+        ofstream file(report);
+        if (file << results.dump(2) << '\n')
+          log("latency report saved at", report);
+        else log("Error writing latency report at " + report);
       };
       void log(function<void(const string&, const string&, const string&)> fn) {
         logger = fn;
       };
+      void resumed() {
+        if (failover.up())
+          log("WS quoting resumed after", to_string(failover.gap()) + "ms offline");
+      };
     protected:
       function<void(const string&, const string&, const string&)> logger;
       void log(const string &reason, const string &highlight = "") {
@@ -690,8 +2376,20 @@ namespace K {
         );
       };
       void reconnect(const string &reason) {
-        countdown = 7;
-        log("WS " + reason + ", reconnecting in " + to_string(countdown) + "s.");
+        if (promote(reason)) connect();
+        else {
+          countdown = 7;
+          log("WS " + reason + ", reconnecting in " + to_string(countdown) + "s.");
+        }
+      };
+      const bool promote(const string &reason) {
+        if (!failover.down() or standby.empty()) return false;
+        swap(ws, standby);
+        log("WS " + reason + ", failover to " + ws);
+        if (write_mConnectivity)                                             // drop the book until the promoted socket sends a full one
+          write_mConnectivity(mConnectivity::Disconnected);
+        askFor(replyLevels, [&]() { return sync_levels(); }, write_mLevels);
+        return true;
       };
   };
 
@@ -704,22 +2402,16 @@ namespace K {
 
   class GwApiREST: public Gw {
     public:
-      const bool askForData(const unsigned int &tick) {
-        return askForSyncData(tick);
-      };
-      const bool waitForData() {
-        return waitForSyncData();
+      void askForData() {
+        askForSyncData();
       };
   };
   class GwApiWS: public Gw {
     public:
       GwApiWS()
       { countdown = 1; };
-      const bool askForData(const unsigned int &tick) {
-        return askForNeverAsyncData(tick);
-      };
-      const bool waitForData() {
-        return waitForNeverAsyncData();
+      void askForData() {
+        askForNeverAsyncData();
       };
   };
 
@@ -733,6 +2425,413 @@ namespace K {
         return nullptr;
       };
   };
+  class GwSim: public Gw {
+    public:
+      GwSim(const mPrice &p, const double &v, const mAmount &w, const mClock &s, const mClock &l, const mClock &j)
+        : mid(p)
+        , volatility(v)
+        , step(s)
+        , latency(l)
+        , jitter(j)
+      {
+        holdings[0] = w;
+        holdings[1] = w * p;
+      };
+      const json handshake() {
+        randId  = mRandom::uuid36Id;
+        symbol  = base + "_" + quote;
+        minTick = 0.01;
+        minSize = 0.001;
+        return nullptr;
+      };
+      bool ready() {
+        if (connected or !(write_mLevels and write_mOrder and write_mTrade
+          and write_mWallets and write_mConnectivity
+        )) return false;
+        connected = true;
+        reply([&]() {
+          write_mConnectivity(mConnectivity::Connected);
+          write_mWallets(wallets());
+        });
+        return true;
+      };
+      void askForData() {
+        timeline.every(step, [&]() {
+          if (minTick) walk();
+        }, 0);
+        if (flood.rate) timeline.every(1, [&]() {
+          if (minTick) stress();
+        }, 0);
+      };
+      void stress(const unsigned int &rate, const string &shape, const bool &ramp) {
+        flood.rate  = min(500000u, rate);
+        flood.shape = shape;
+        flood.ramp  = ramp;
+      };
+      void place(mRandId orderId, mSide side, string price, string qty, mOrderType type, mTimeInForce tif, bool postOnly) {
+        request([=]() {
+          enter(orderId, side, strD(price.data()), strD(qty.data()), type, tif, postOnly);
+          levels();
+        });
+      };
+      void place_batch(const vector<mOrder*> &orders) {
+        budget.take("place", true);
+        vector<mOrder> batch;
+        for (mOrder *const it : orders) {
+          lifecycle.sent(it);
+          batch.push_back(*it);
+        }
+        request([=]() {
+          for (const mOrder &it : batch)
+            enter(it.orderId, it.side, it.price, it.quantity, it.type, it.timeInForce, it.preferPostOnly);
+          levels();
+        });
+      };
+      void cancel(mRandId orderId, mRandId exchangeId) {
+        request([=]() {
+          remove(orderId, exchangeId);
+          levels();
+        });
+      };
+      void cancel_batch(const vector<mOrder*> &orders) {
+        budget.take("cancel", true);
+        vector<mRandId> batch;
+        for (mOrder *const it : orders) {
+          lifecycle.canceled(it);
+          batch.push_back(it->orderId);
+        }
+        request([=]() {
+          for (const mRandId &it : batch) remove(it);
+          levels();
+        });
+      };
+      void close() {};
+      const mClock cycle() {
+        const function<void(const mOrder&)>   orders = write_mOrder;
+        const function<void(const mLevels&)>  book   = write_mLevels;
+        const function<void(const mTrade&)>   trades = write_mTrade;
+        const function<void(const mWallets&)> funds  = write_mWallets;
+        const mRandId orderId = randId();
+        mStatus status = mStatus::Waiting;
+        write_mOrder   = [&](const mOrder &k) {
+          if (k.orderId == orderId) status = k.status;
+        };
+        write_mLevels  = [](const mLevels&) {};
+        write_mTrade   = [](const mTrade&) {};
+        write_mWallets = [](const mWallets&) {};
+        const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        const function<void(const mStatus&)> await = [&](const mStatus &until) {
+          while (status != until) {
+            timeline.advance();
+            this_thread::sleep_for(chrono::microseconds(100));
+          }
+        };
+        place(orderId, mSide::Bid, strX(ROUND(mid / 2, minTick), 2), strX(minSize, 3), mOrderType::Limit, mTimeInForce::GTC, true);
+        await(mStatus::Working);
+        cancel(orderId, "");
+        await(mStatus::Terminated);
+        const mClock stop = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+        while (clockwork.fresh() <= max(queued, last)) {
+          timeline.advance(clockwork.fresh());
+          this_thread::sleep_for(chrono::microseconds(100));
+        }
+        write_mOrder   = orders;
+        write_mLevels  = book;
+        write_mTrade   = trades;
+        write_mWallets = funds;
+        return stop;
+      };
+    protected:
+      vector<mOrder> sync_cancelAll() {
+        vector<mOrder> orders;
+        for (const unordered_map<mRandId, mResting>::value_type &it : ours)
+          orders.push_back(mOrder(it.first, it.second.exchangeId, mStatus::Terminated, 0, 0, 0));
+        ours.clear();
+        bids.clear();
+        asks.clear();
+        return orders;
+      };
+    private:
+      struct mResting {
+        mRandId exchangeId;
+          mSide side     = (mSide)0;
+           long ticks    = 0;
+        mAmount left     = 0;
+      };
+      struct mQueued {
+        mRandId orderId;
+        mAmount left     = 0;
+      };
+      map<long, deque<mQueued>, greater<long>> bids;
+      map<long, deque<mQueued>>                asks;
+      unordered_map<mRandId, mResting> ours;
+      mPrice mid;
+      double volatility;
+      mAmount holdings[2];
+      mClock step,
+             latency,
+             jitter,
+             queued = 0,
+             last   = 0;
+      unsigned long sequence = 0;
+      bool connected = false;
+      mt19937 random = mt19937(random_device()());
+      struct mFlood {
+        unsigned int rate = 0;
+              string shape;
+                bool ramp = false;
+              mClock start = 0;
+       unsigned long sent  = 0;
+              double delay = 0,
+                     worst = 0;
+                long center = 0;
+             mLevels feed;
+      } flood;
+      void stress() {
+        const mClock now = clockwork.fresh();
+        if (!flood.start) {
+          flood.start  = now;
+          flood.sent   = 0;
+          flood.delay  = flood.worst = 0;
+          flood.center = lround(mid / minTick);
+          flood.feed   = mLevels();
+          for (unsigned int i = 0; i < 21; ++i) {
+            flood.feed.bids.push_back(mLevel((flood.center - 1 - i) * minTick, minSize * (1 + i)));
+            flood.feed.asks.push_back(mLevel((flood.center + 1 + i) * minTick, minSize * (1 + i)));
+          }
+        }
+        const double burst = flood.rate / 1e+1;
+        const unsigned long due = flood.shape == "bursty"
+          ? burst * ((now - flood.start) / 100) + fmin(burst, burst * ((now - flood.start) % 100) / 1e+1)
+          : flood.rate * (now - flood.start) / 1e+3;
+        while (flood.sent < due and clockwork.fresh() < now + 10) {
+          const double intended = flood.shape == "bursty"
+            ? 1e+2 * floor(flood.sent / burst) + 1e+1 * fmod(flood.sent, burst) / burst
+            : 1e+3 * flood.sent / flood.rate;
+          inject(flood.sent++);
+          const double delay = fmax(0, clockwork.fresh() - flood.start - intended);
+          flood.delay += delay;
+          flood.worst = fmax(flood.worst, delay);
+        }
+        if (now - flood.start < 5e+3) return;
+        const double sustained = 1e+3 * flood.sent / (clockwork.fresh() - flood.start);
+        const bool saturated = sustained < flood.rate * 9e-1 or flood.worst > 1e+3;
+        log("stress " + flood.shape + " feed of " + to_string(flood.rate) + " msg/s processed",
+          to_string((unsigned int)sustained) + " msg/s with "
+          + strX(flood.sent ? flood.delay / flood.sent : 0, 1) + "ms average and "
+          + strX(flood.worst, 1) + "ms worst queueing delay"
+          + (saturated ? " (saturated)" : ""));
+        if (flood.ramp) {
+          if (saturated) {
+            log("stress saturation point", to_string((unsigned int)sustained) + " msg/s");
+            flood.ramp = false;
+            flood.rate = max(1u, (unsigned int)(sustained * 9e-1));
+          } else if (flood.rate < 500000) flood.rate = min(500000u, flood.rate * 2);
+        }
+        flood.start = 0;
+      };
+      void inject(const unsigned long &i) {
+        mLevels &feed = flood.feed;
+        if (i % 8 == 7) {
+          write_mTrade(mTrade(
+            (i % 16 == 7 ? feed.bids : feed.asks)[0].price,
+            minSize,
+            i % 16 == 7 ? mSide::Ask : mSide::Bid,
+            Tstamp
+          ));
+          return;
+        }
+        if (flood.shape == "trending" and i % 64 == 0) {
+          ++flood.center;
+          for (mLevel &it : feed.bids) it.price += minTick;
+          for (mLevel &it : feed.asks) it.price += minTick;
+        }
+        vector<mLevel> &side = i % 2 ? feed.asks : feed.bids;
+        if (!side.empty()) side[(i / 2) % side.size()].size = minSize * (1 + i % 97);
+        if (flood.shape == "crossed" and i % 16 == 0) {
+          const mPrice price = feed.bids[0].price;
+          feed.bids[0].price = feed.asks[0].price + minTick;
+          write_mLevels(feed);
+          feed.bids[0].price = price;
+        } else if (flood.shape == "empty" and i % 16 == 0) {
+          vector<mLevel> asks;
+          asks.swap(feed.asks);
+          write_mLevels(feed);
+          asks.swap(feed.asks);
+        } else write_mLevels(feed);
+      };
+      const mClock delay() {
+        return latency + (jitter ? random() % (jitter + 1) : 0);
+      };
+      void request(const function<void()> &fn) {
+        const mClock now = Tstamp;
+        queued = max(now + delay(), queued);
+        timeline.after(queued - now, fn);
+      };
+      void reply(const function<void()> &fn) {
+        const mClock now = Tstamp;
+        last = max(now + delay(), last);
+        timeline.after(last - now, fn);
+      };
+      void reply(const mOrder &order) {
+        reply([=]() { write_mOrder(order); });
+      };
+      void walk() {
+        mid *= exp(volatility * normal_distribution<double>()(random));
+        synthetic(bids);
+        synthetic(asks);
+        const long spread = 1 + random() % 3,
+                   center = lround(mid / minTick);
+        mAmount size;
+        for (unsigned int i = 0; i < 21; ++i) {
+          size = minSize * (1 + random() % 100);
+          if (!match(mSide::Ask, center + spread + i, size, ""))
+            asks[center + spread + i].push_back({"", size});
+          size = minSize * (1 + random() % 100);
+          if (!match(mSide::Bid, center - spread - i, size, ""))
+            bids[center - spread - i].push_back({"", size});
+        }
+        if (random() % 2) {
+          const mSide side = random() % 2 ? mSide::Bid : mSide::Ask;
+          match(side, side == mSide::Bid ? LONG_MAX : 0, minSize * (1 + random() % 50), "");
+        }
+        levels();
+      };
+      void enter(const mRandId &orderId, const mSide &side, const mPrice &price, const mAmount &quantity, const mOrderType &type, const mTimeInForce &tif, const bool &postOnly) {
+        const long ticks = type == mOrderType::Market
+          ? (side == mSide::Bid ? LONG_MAX : 0)
+          : lround(price / minTick);
+        const mRandId exchangeId = to_string(++sequence);
+        if (quantity < minSize or (postOnly and crosses(side, ticks))
+          or (tif == mTimeInForce::FOK and depth(side, ticks) < quantity)
+        ) {
+          reply(mOrder(orderId, exchangeId, mStatus::Terminated, 0, 0, 0));
+          return;
+        }
+        reply(mOrder(orderId, exchangeId, mStatus::Working, 0, 0, 0));
+        ours[orderId] = {exchangeId, side, ticks, quantity};
+        if (match(side, ticks, quantity, orderId)) return;
+        if (tif != mTimeInForce::GTC or type == mOrderType::Market)
+          terminate(orderId);
+        else if (side == mSide::Bid) bids[ticks].push_back({orderId, ours[orderId].left});
+        else asks[ticks].push_back({orderId, ours[orderId].left});
+      };
+      void remove(const mRandId &orderId, const mRandId &exchangeId = "") {
+        if (ours.find(orderId) == ours.end()) {
+          reply(mOrder(orderId, exchangeId, mStatus::Terminated, 0, 0, 0));
+          return;
+        }
+        unlink(orderId);
+        terminate(orderId);
+      };
+      template <typename T> void synthetic(T &book) {
+        for (typename T::iterator it = book.begin(); it != book.end();) {
+          it->second.erase(remove_if(it->second.begin(), it->second.end(), [](const mQueued &k) {
+            return k.orderId.empty();
+          }), it->second.end());
+          if (it->second.empty()) it = book.erase(it);
+          else ++it;
+        }
+      };
+      const bool crosses(const mSide &side, const long &ticks) const {
+        return side == mSide::Bid
+          ? !asks.empty() and asks.begin()->first <= ticks
+          : !bids.empty() and bids.begin()->first >= ticks;
+      };
+      const mAmount depth(const mSide &side, const long &ticks) const {
+        mAmount total = 0;
+        if (side == mSide::Bid) {
+          for (const map<long, deque<mQueued>>::value_type &it : asks)
+            if (it.first > ticks) break;
+            else for (const mQueued &k : it.second) total += k.left;
+        } else {
+          for (const map<long, deque<mQueued>, greater<long>>::value_type &it : bids)
+            if (it.first < ticks) break;
+            else for (const mQueued &k : it.second) total += k.left;
+        }
+        return total;
+      };
+      const bool match(const mSide &side, const long &ticks, mAmount quantity, const mRandId &taker) {
+        return side == mSide::Bid
+          ? sweep(asks, side, ticks, quantity, taker)
+          : sweep(bids, side, ticks, quantity, taker);
+      };
+      template <typename T> const bool sweep(T &book, const mSide &side, const long &ticks, mAmount &quantity, const mRandId &taker) {
+        while (quantity >= minSize and !book.empty() and crosses(side, ticks)) {
+          deque<mQueued> &queue = book.begin()->second;
+          mQueued &maker = queue.front();
+          const mPrice  price = book.begin()->first * minTick;
+          const mAmount size  = fmin(quantity, maker.left);
+          quantity   -= size;
+          maker.left -= size;
+          fill(maker.orderId, price, size);
+          fill(taker, price, size);
+          reply([=]() { write_mTrade(mTrade(price, size, side, Tstamp)); });
+          if (maker.left < minSize) {
+            if (!maker.orderId.empty()) terminate(maker.orderId);
+            queue.pop_front();
+            if (queue.empty()) book.erase(book.begin());
+          }
+        }
+        return quantity < minSize;
+      };
+      void fill(const mRandId &orderId, const mPrice &price, const mAmount &size) {
+        if (orderId.empty() or ours.find(orderId) == ours.end()) return;
+        mResting &order = ours[orderId];
+        order.left -= size;
+        holdings[0] += order.side == mSide::Bid ? size : -size;
+        holdings[1] += order.side == mSide::Bid ? -size * price : size * price;
+        reply(mOrder(orderId, order.exchangeId, order.left < minSize
+          ? mStatus::Terminated
+          : mStatus::Working, price, 0, size));
+        if (order.left < minSize) ours.erase(orderId);
+        reply([&]() { write_mWallets(wallets()); });
+      };
+      void unlink(const mRandId &orderId) {
+        const mResting &order = ours[orderId];
+        if (order.side == mSide::Bid) unlink(bids, order.ticks, orderId);
+        else unlink(asks, order.ticks, orderId);
+      };
+      template <typename T> void unlink(T &book, const long &ticks, const mRandId &orderId) {
+        typename T::iterator it = book.find(ticks);
+        if (it == book.end()) return;
+        it->second.erase(remove_if(it->second.begin(), it->second.end(), [&](const mQueued &k) {
+          return k.orderId == orderId;
+        }), it->second.end());
+        if (it->second.empty()) book.erase(it);
+      };
+      void terminate(const mRandId &orderId) {
+        if (ours.find(orderId) == ours.end()) return;
+        reply(mOrder(orderId, ours[orderId].exchangeId, mStatus::Terminated, 0, 0, 0));
+        ours.erase(orderId);
+        reply([&]() { write_mWallets(wallets()); });
+      };
+      void levels() {
+        if (flood.rate) return;
+        mLevels levels;
+        for (const map<long, deque<mQueued>, greater<long>>::value_type &it : bids) {
+          if (levels.bids.size() == (size_t)maxLevel) break;
+          levels.bids.push_back(mLevel(it.first * minTick, 0));
+          for (const mQueued &k : it.second) levels.bids.back().size += k.left;
+        }
+        for (const map<long, deque<mQueued>>::value_type &it : asks) {
+          if (levels.asks.size() == (size_t)maxLevel) break;
+          levels.asks.push_back(mLevel(it.first * minTick, 0));
+          for (const mQueued &k : it.second) levels.asks.back().size += k.left;
+        }
+        reply([=]() { write_mLevels(levels); });
+      };
+      const mWallets wallets() const {
+        mAmount held[2] = {0, 0};
+        for (const unordered_map<mRandId, mResting>::value_type &it : ours)
+          if (it.second.side == mSide::Bid) held[1] += it.second.left * it.second.ticks * minTick;
+          else held[0] += it.second.left;
+        return mWallets(
+          mWallet(holdings[0] - held[0], held[0], base),
+          mWallet(holdings[1] - held[1], held[1], quote)
+        );
+      };
+  };
   class GwHitBtc: public GwApiWS {
     public:
       GwHitBtc()
@@ -741,6 +2840,7 @@ namespace K {
         ws   = "wss://api.hitbtc.com/api/2/ws";
       };
       const json handshake() {
+        budget.limit(100, 100);
         randId = mRandom::uuid32Id;
         symbol = base + quote;
         const json reply = mREST::xfer(http + "/public/symbol/" + symbol);
@@ -767,6 +2867,7 @@ namespace K {
         ws   = "wss://real.okex.com:10441/websocket";
       };
       const json handshake() {
+        budget.limit(10, 20);
         randId = mRandom::char16Id;
         symbol = strL(base + "_" + quote);
         minTick = 0.0001;
@@ -813,6 +2914,7 @@ namespace K {
         fix  = "fix.pro.coinbase.com:4198";
       };
       const json handshake() {
+        budget.limit(5, 10);
         randId = mRandom::uuid36Id;
         symbol = base + "-" + quote;
         const json reply = mREST::xfer(http + "/products/" + symbol);
@@ -842,6 +2944,7 @@ namespace K {
         askForReplace = true;
       };
       const json handshake() {
+        budget.limit(1.5, 10);
         randId = mRandom::int45Id;
         symbol = strL(base + quote);
         const json reply1 = mREST::xfer(http + "/pubticker/" + symbol);
@@ -889,6 +2992,7 @@ namespace K {
         ws   = "wss://api.fcoin.com/v2/ws";
       };
       const json handshake() {
+        budget.limit(10, 100);
         randId = mRandom::char16Id;
         symbol = strL(base + quote);
         const json reply = mREST::xfer(http + "public/symbols");
@@ -926,6 +3030,9 @@ namespace K {
         http = "https://api.kraken.com";
       };
       const json handshake() {
+        budget.limit(0.33, 15);
+        budget.weight("levels", 0);
+        budget.weight("trades", 0);
         randId = mRandom::int32Id;
         symbol = base + quote;
         const json reply = mREST::xfer(http + "/0/public/AssetPairs?pair=" + symbol);
@@ -962,6 +3069,7 @@ namespace K {
         http = "https://api.korbit.co.kr/v1";
       };
       const json handshake() {
+        budget.limit(10, 20);
         randId = mRandom::int45Id;
         symbol = strL(base + "_" + quote);
         const json reply = mREST::xfer(http + "/constants");
@@ -991,6 +3099,7 @@ namespace K {
         http = "https://poloniex.com";
       };
       const json handshake() {
+        budget.limit(6, 6);
         randId = mRandom::int45Id;
         symbol = quote + "_" + base;
         const json reply = mREST::xfer(http + "/public?command=returnTicker");
@@ -1001,6 +3110,44 @@ namespace K {
         }
         return reply;
       };
+    protected:
+      bool async_levels() {
+        if (!replyLevels) {
+          replyLevels = true;
+          mREST::curl_async(http + "/public?command=returnOrderBook&currencyPair=" + symbol
+            + "&depth=" + to_string(maxLevel), [](CURL *curl, curl_slist **h_) {
+              curl_easy_setopt(curl, CURLOPT_TIMEOUT, 13L);
+            }, [&](const string &reply) {
+              replyLevels = false;
+              mLevels levels;
+              levels.bids.reserve(maxLevel);
+              levels.asks.reserve(maxLevel);
+              if (book(reply, levels))
+                write_mLevels(levels);
+            }
+          );
+        }
+        return true;
+      };
+    public:
+      static const bool book(const string &reply, mLevels &levels) {
+        struct mBook {
+          mLevels &levels;
+             bool bids = false,
+                  asks = false;
+        } into = {levels};
+        static const mFields<mBook> fields({
+          {"bids",     [](mBook &k, const double &num, const string &str) { k.bids = true; }},
+          {"bids/*",   [](mBook &k, const double &num, const string &str) { k.levels.bids.emplace_back(); }},
+          {"bids/*/0", [](mBook &k, const double &num, const string &str) { k.levels.bids.back().price = num; }},
+          {"bids/*/1", [](mBook &k, const double &num, const string &str) { k.levels.bids.back().size = num; }},
+          {"asks",     [](mBook &k, const double &num, const string &str) { k.asks = true; }},
+          {"asks/*",   [](mBook &k, const double &num, const string &str) { k.levels.asks.emplace_back(); }},
+          {"asks/*/0", [](mBook &k, const double &num, const string &str) { k.levels.asks.back().price = num; }},
+          {"asks/*/1", [](mBook &k, const double &num, const string &str) { k.levels.asks.back().size = num; }}
+        });
+        return fields.decode(reply, into) and into.bids and into.asks;
+      };
     protected:
       static const json xfer(const string &url, const string &post, const string &h1, const string &h2) {
         return mREST::curl_perform(url, [&](CURL *curl) {
@@ -115,7 +115,7 @@ namespace K {
                                                "\n" "default IP is the system default network interface"},
           {"exchange",     "NAME",   "NULL",   "set exchange NAME for trading, mandatory one of:"
                                                "\n" "'COINBASE', 'BITFINEX',  'BITFINEX_MARGIN',"
-                                               "\n" "'HITBTC', 'OKCOIN', 'OKEX', 'KORBIT', 'POLONIEX' or 'NULL'"},
+                                               "\n" "'HITBTC', 'OKCOIN', 'OKEX', 'KORBIT', 'POLONIEX', 'SIM' or 'NULL'"},
           {"currency",     "PAIR",   "NULL",   "set currency PAIR for trading, use format"
                                                "\n" "with '/' separator, like 'BTC/EUR'"},
           {"apikey",       "WORD",   "NULL",   "set (never share!) WORD as api key for trading, mandatory"},
@@ -127,9 +127,31 @@ namespace K {
           {"http",         "URL",    "",       "set URL of alernative HTTPS api endpoint for trading"},
           {"wss",          "URL",    "",       "set URL of alernative WSS api endpoint for trading"},
           {"fix",          "URL",    "",       "set URL of alernative FIX api endpoint for trading"},
+          {"wss-standby",  "URL",    "",       "set URL of mirror WSS api endpoint to failover at once,"
+                                               "\n" "without waiting for reconnect when the WSS connection drops"},
           {"market-limit", "NUMBER", "321",    "set NUMBER of maximum price levels for the orderbook,"
                                                "\n" "default NUMBER is '321' and the minimum is '15'."
-                                               "\n" "locked bots smells like '--market-limit=3' spirit"}
+                                               "\n" "locked bots smells like '--market-limit=3' spirit"},
+          {"gw-threads",   "NUMBER", "4",      "set NUMBER of threads for blocking gateway api calls"},
+          {"gw-queue",     "NUMBER", "32",     "set NUMBER of maximum pending gateway api calls,"
+                                               "\n" "polls are skipped while the queue is full"},
+          {"cpu-loop",     "LIST",   "",       "set LIST of cpus to pin the thread of market data and quoting loop,"
+                                               "\n" "like '2' or '2-3,6', default LIST is '' (not pinned)"},
+          {"cpu-gateway",  "LIST",   "",       "set LIST of cpus to pin the threads of gateway api calls"},
+          {"cpu-screen",   "LIST",   "",       "set LIST of cpus to pin the thread of terminal hotkeys"},
+          {"loop-fifo",    "NUMBER", "0",      "set NUMBER as SCHED_FIFO priority of the loop thread,"
+                                               "\n" "from '1' to '99', default NUMBER is '0' (not realtime)"},
+          {"sim-price",    "AMOUNT", "1000",   "set AMOUNT as initial price of the random walk of '--exchange=SIM'"},
+          {"sim-stdev",    "AMOUNT", "0.0005", "set AMOUNT as stdev of each random walk step of '--exchange=SIM'"},
+          {"sim-wallet",   "AMOUNT", "10",     "set AMOUNT of base currency (and its value in quote) of '--exchange=SIM'"},
+          {"sim-step",     "NUMBER", "250",    "set NUMBER of milliseconds between random walk steps of '--exchange=SIM'"},
+          {"sim-latency",  "NUMBER", "50",     "set NUMBER of milliseconds of one way latency of '--exchange=SIM'"},
+          {"sim-jitter",   "NUMBER", "20",     "set NUMBER of milliseconds of random extra latency of '--exchange=SIM'"},
+          {"sim-stress",   "NUMBER", "0",      "set NUMBER of market data messages per second injected by '--exchange=SIM',"
+                                               "\n" "from '1000' to '500000', default NUMBER is '0' (disabled)"},
+          {"sim-shape",    "WORD",   "steady", "set WORD as shape of '--sim-stress' feed, one of:"
+                                               "\n" "'steady', 'bursty', 'trending', 'crossed' or 'empty'"},
+          {"sim-ramp",     "1",      0,        "double '--sim-stress' every 5 seconds until saturation is reported"}
         };
         for (const Argument &it : custom_long_options()) long_options.push_back(it);
         for (const Argument &it : (vector<Argument>){
@@ -191,6 +213,7 @@ namespace K {
       };
       void handshake(const vector<pair<string, string>> &notes = {}) {
         gateway(gw->handshake());
+        mREST::warmup(gw->http);
         gw->info(notes);
       };
     private:
@@ -217,7 +240,19 @@ namespace K {
         );
       };
       void gateway() {
-        if (!(gw = Gw::new_Gw(str("exchange"))))
+        if (str("exchange") == "SIM") {
+          GwSim *const sim = new GwSim(
+            dec("sim-price"),
+            dec("sim-stdev"),
+            dec("sim-wallet"),
+            max(1, num("sim-step")),
+            max(0, num("sim-latency")),
+            max(0, num("sim-jitter"))
+          );
+          sim->stress(max(0, num("sim-stress")), str("sim-shape"), num("sim-ramp"));
+          gw = sim;
+        } else gw = Gw::new_Gw(str("exchange"));
+        if (!gw)
           error("CF",
             "Unable to configure a valid gateway using --exchange="
               + str("exchange") + " argument"
@@ -232,9 +267,15 @@ namespace K {
         gw->secret   = str("secret");
         gw->user     = str("username");
         gw->pass     = str("passphrase");
+        gw->standby  = str("wss-standby");
         gw->maxLevel = num("market-limit");
         gw->debug    = num("debug-secret");
         gw->version  = num("free-version");
+        topology.pin("loop",    str("cpu-loop"));
+        topology.pin("gateway", str("cpu-gateway"));
+        topology.pin("screen",  str("cpu-screen"));
+        topology.fifo("loop",   num("loop-fifo"));
+        gw->workers.start(num("gw-threads"), num("gw-queue"));
       };
       void gateway(const json &reply) {
         if (!gw->randId or gw->symbol.empty())
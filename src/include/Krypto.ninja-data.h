@@ -114,6 +114,14 @@ namespace K {
     virtual const bool realtime() const {
       return true;
     };
+    virtual const function<const string()> snapshot() const {
+      const shared_ptr<const json> blob_ = make_shared<const json>(blob());
+      return [blob_]() { return blob_->dump(); };
+    };
+    protected:
+      template <typename mPlain> static const function<const string()> later(const mPlain &k) {
+        return [k]() { return json(k).dump(); };
+      };
   };
   template <typename mData> struct mJsonToClient: public mToClient {
     virtual const bool send() {
@@ -128,15 +136,21 @@ namespace K {
     virtual const json blob() const {
       return *(mData*)this;
     };
+    virtual const function<const string()> snapshot() const {
+      if (send_same_blob()) return mToClient::snapshot();
+      const shared_ptr<const json> blob_ = send_last_blob;
+      return [blob_]() { return blob_->dump(); };
+    };
     protected:
       mClock send_last_Tstamp = 0;
-      string send_last_blob;
+      shared_ptr<const json> send_last_blob = make_shared<const json>();
       virtual const bool send_same_blob() const {
         return true;
       };
       const bool diff_blob() {
-        const string last_blob = send_last_blob;
-        return (send_last_blob = blob().dump()) != last_blob;
+        const shared_ptr<const json> last_blob = send_last_blob;
+        send_last_blob = make_shared<const json>(blob());
+        return *send_last_blob != *last_blob;
       };
       virtual const bool send_asap() const {
         return true;
@@ -164,6 +178,9 @@ namespace K {
     virtual const string increment() const { return "NULL"; };
     virtual const double limit()     const { return 0; };
     virtual const mClock lifetime()  const { return 0; };
+    virtual const size_t width()     const { return 0; };
+    virtual const mClock pack(const size_t&, double *const) const { return 0; };
+    virtual const bool unpack(const vector<mClock>&, const vector<double>&) { return false; };
     virtual const string explain()   const = 0;
     virtual       string explainOK() const = 0;
     virtual       string explainKO() const { return ""; };
@@ -228,6 +245,14 @@ namespace K {
         rows.push_back(it);
       return !empty();
     };
+    virtual const bool unpack(const vector<mClock> &times, const vector<double> &values) {
+      for (size_t i = 0; i < times.size(); ++i)
+        rows.push_back(row(times.at(i), values.data() + i * width()));
+      return !empty();
+    };
+    virtual const mData row(const mClock&, const double *const) const {
+      return mData();
+    };
     virtual const json blob() const {
       return back();
     };
@@ -236,6 +261,141 @@ namespace K {
     };
   };
 
+  class mSeries {
+    public:
+      function<const string(sqlite3_stmt *const, const string&, const function<void()>&)> step;
+      static const size_t blockRows = 64;
+    private:
+      sqlite3 *db = nullptr;
+      mFromDb *data = nullptr;
+      size_t width = 0;
+      sqlite3_int64 id = 0;
+      vector<mClock> times;
+      vector<double> values;
+      sqlite3_stmt *legacy = nullptr,
+                   *clear  = nullptr,
+                   *blocks = nullptr,
+                   *insert = nullptr,
+                   *update = nullptr,
+                   *expire = nullptr;
+    public:
+      ~mSeries() {
+        for (sqlite3_stmt *const it : {legacy, clear, blocks, insert, update, expire})
+          sqlite3_finalize(it);
+      };
+      const string open(sqlite3 *const handle, mFromDb *const k, const string &table) {
+        db    = handle;
+        data  = k;
+        width = k->width();
+        const string series = table + "_blocks";
+        string reason;
+        char *zErrMsg = nullptr;
+        sqlite3_exec(db, ("CREATE TABLE IF NOT EXISTS " + series + "("
+          + "id     INTEGER   PRIMARY KEY AUTOINCREMENT  NOT NULL,"
+          + "first  INTEGER                              NOT NULL,"
+          + "last   INTEGER                              NOT NULL,"
+          + "rows   INTEGER                              NOT NULL,"
+          + "data   BLOB                                 NOT NULL);").data(), nullptr, nullptr, &zErrMsg);
+        if (zErrMsg) reason = "SQLite error: " + string(zErrMsg);
+        sqlite3_free(zErrMsg);
+        for (const pair<sqlite3_stmt**, string> &it : (vector<pair<sqlite3_stmt**, string>>){
+          {&legacy, "SELECT json,time FROM " + table + " WHERE time >= ?1 ORDER BY time ASC;"                     },
+          {&clear,  "DELETE FROM " + table + ";"                                                                  },
+          {&blocks, "SELECT data FROM " + series + " ORDER BY id ASC;"                                            },
+          {&insert, "INSERT INTO " + series + " (first,last,rows,data) VALUES(?1,?2,?3,?4);"                      },
+          {&update, "UPDATE " + series + " SET first = ?1, last = ?2, rows = ?3, data = ?4 WHERE id = ?5;"        },
+          {&expire, "DELETE FROM " + series + " WHERE last < ?1;"                                                 }
+        }) if (sqlite3_prepare_v2(db, it.second.data(), it.second.length() + 1, it.first, nullptr) != SQLITE_OK
+          and reason.empty()
+        ) reason = "SQLite error: " + (sqlite3_errmsg(db) + (" at " + it.second));
+        return reason;
+      };
+      const bool load(const mClock &cutoff, string &reason) {
+        vector<mClock> t;
+        vector<double> v;
+        sqlite3_bind_int64(expire, 1, cutoff);
+        reason = step(expire, "expire", nullptr);
+        if (reason.empty()) reason = step(blocks, "blocks", [&]() {
+          decode(
+            (const char*)sqlite3_column_blob(blocks, 0),
+            sqlite3_column_bytes(blocks, 0),
+            t, v
+          );
+        });
+        if (!reason.empty()) return false;
+        const size_t expired = lower_bound(t.begin(), t.end(), cutoff) - t.begin();
+        t.erase(t.begin(), t.begin() + expired);
+        v.erase(v.begin(), v.begin() + expired * width);
+        return t.empty()
+          ? migrate(cutoff, reason)
+          : data->unpack(t, v);
+      };
+      const string append(const mClock &time, const double *const row, const mClock &cutoff) {
+        string reason;
+        if (times.size() >= blockRows) {
+          id = 0;
+          times.clear();
+          values.clear();
+          sqlite3_bind_int64(expire, 1, cutoff);
+          reason = step(expire, "expire", nullptr);
+        }
+        times.push_back(time);
+        values.insert(values.end(), row, row + width);
+        const string blob = encode();
+        sqlite3_stmt *const stmt = id ? update : insert;
+        sqlite3_bind_int64(stmt, 1, times.front());
+        sqlite3_bind_int64(stmt, 2, times.back());
+        sqlite3_bind_int64(stmt, 3, times.size());
+        sqlite3_bind_blob(stmt, 4, blob.data(), blob.length(), SQLITE_STATIC);
+        if (id) sqlite3_bind_int64(stmt, 5, id);
+        const string failed = step(stmt, id ? "update" : "append", nullptr);
+        if (!id and failed.empty()) id = sqlite3_last_insert_rowid(db);
+        return reason.empty() ? failed : reason;
+      };
+    private:
+      const bool migrate(const mClock &cutoff, string &reason) {
+        json rows = json::array();
+        vector<mClock> stamps;
+        sqlite3_bind_int64(legacy, 1, cutoff);
+        reason = step(legacy, "select", [&]() {
+          rows.push_back(json::parse(string(
+            (const char*)sqlite3_column_blob(legacy, 0),
+            sqlite3_column_bytes(legacy, 0)
+          )));
+          stamps.push_back(sqlite3_column_int64(legacy, 1));
+        });
+        if (!reason.empty() or !data->pull(rows)) return false;
+        vector<double> row(width);
+        for (size_t i = 0; i < stamps.size() and reason.empty(); ++i) {
+          data->pack(stamps.size() - 1 - i, row.data());
+          reason = append(stamps[i], row.data(), cutoff);
+        }
+        if (reason.empty()) reason = step(clear, "clear", nullptr);
+        return true;
+      };
+      const string encode() const {
+        const size_t rows = times.size();
+        string blob(rows * (sizeof(mClock) + width * sizeof(double)), '\0');
+        char *const column = &blob[0] + rows * sizeof(mClock);
+        memcpy(&blob[0], times.data(), rows * sizeof(mClock));
+        for (size_t c = 0; c < width; ++c)
+          for (size_t r = 0; r < rows; ++r)
+            memcpy(column + (c * rows + r) * sizeof(double), &values[r * width + c], sizeof(double));
+        return blob;
+      };
+      void decode(const char *const blob, const size_t &length, vector<mClock> &t, vector<double> &v) const {
+        const size_t rows   = length / (sizeof(mClock) + width * sizeof(double)),
+                     offset = t.size();
+        const char *const column = blob + rows * sizeof(mClock);
+        t.resize(offset + rows);
+        v.resize((offset + rows) * width);
+        memcpy(&t[offset], blob, rows * sizeof(mClock));
+        for (size_t c = 0; c < width; ++c)
+          for (size_t r = 0; r < rows; ++r)
+            memcpy(&v[(offset + r) * width + c], column + (c * rows + r) * sizeof(double), sizeof(double));
+      };
+  };
+
   struct mQuotingParams: public mStructFromDb<mQuotingParams>,
                          public mJsonToClient<mQuotingParams> {
     mPrice            widthPing                       = 2.0;
@@ -376,6 +536,9 @@ namespace K {
     const mMatter about() const {
       return mMatter::QuotingParameters;
     };
+    const function<const string()> snapshot() const {
+      return later(*this);
+    };
     const string explain() const {
       return "Quoting Parameters";
     };
@@ -572,6 +735,7 @@ namespace K {
       mOrder *const upsert(const mOrder &raw) {
         mOrder *const order = findsert(raw);
         mOrder::update(raw, order);
+        expire(order);
         if (debug()) {
           report(order, " saved ");
           report_size();
@@ -580,11 +744,13 @@ namespace K {
       };
       const bool replace(const mPrice &price, const bool &isPong, mOrder *const order) {
         const bool allowed = mOrder::replace(price, isPong, order);
+        if (allowed) expire(order);
         if (debug()) report(order, "replace");
         return allowed;
       };
       const bool cancel(mOrder *const order) {
         const bool allowed = mOrder::cancel(order);
+        if (allowed) expire(order);
         if (debug()) report(order, "cancel ");
         return allowed;
       };
@@ -598,6 +764,7 @@ namespace K {
         mOrder *const order = upsert(raw);
         updated = {order, raw};
         if (!order) return;
+        gw->lifecycle.read(raw, order);
         if (order->status == mStatus::Terminated)
           purge(order);
         send();
@@ -612,7 +779,28 @@ namespace K {
       const json blob() const {
         return working();
       };
+      const function<const string()> snapshot() const {
+        const vector<mOrder> orders_ = working();
+        return [orders_]() { return json(orders_).dump(); };
+      };
     private:
+      void expire(mOrder *const order) {
+        if (!order or order->status == mStatus::Terminated) return;
+        order->zombie = order->mature = false;
+        const mRandId orderId = order->orderId;
+        const mClock  time    = order->time;
+        const bool    waiting = order->status == mStatus::Waiting;
+        if (waiting or args->num("lifetime"))
+          timeline.after(waiting ? 10e+3 : args->num("lifetime"), [this, orderId, time, waiting]() {
+            mOrder *const order = find(orderId);
+            if (!order
+              or order->time != time
+              or waiting != (order->status == mStatus::Waiting)
+            ) return;
+            if (waiting) order->zombie = true;
+            else         order->mature = true;
+          });
+      };
       void report(const mOrder *const order, const string &reason) const {
         print("DEBUG OG", " " + reason + " " + (
           order
@@ -658,6 +846,9 @@ namespace K {
     const json blob() const {
       return trades.back();
     };
+    const function<const string()> snapshot() const {
+      return later(trades.back());
+    };
     const json hello() {
       return trades;
     };
@@ -723,11 +914,26 @@ namespace K {
     k.topBid = j.value("bid", 0.0);
     k.topAsk = j.value("ask", 0.0);
   };
-  struct mStdevs: public mVectorFromDb<mStdev> {
+  struct mStdevValues {
     double top  = 0,  topMean = 0,
            fair = 0, fairMean = 0,
            bid  = 0,  bidMean = 0,
            ask  = 0,  askMean = 0;
+  };
+  static void to_json(json &j, const mStdevValues &k) {
+    j = {
+      {      "fv", k.fair    },
+      {  "fvMean", k.fairMean},
+      {    "tops", k.top     },
+      {"topsMean", k.topMean },
+      {     "bid", k.bid     },
+      { "bidMean", k.bidMean },
+      {     "ask", k.ask     },
+      { "askMean", k.askMean }
+    };
+  };
+  struct mStdevs: public mVectorFromDb<mStdev>,
+                  public mStdevValues {
     private_ref:
       const mPrice &fairValue;
     public:
@@ -739,16 +945,17 @@ namespace K {
         if (loaded) calc();
         return loaded;
       };
-      void timer_1s(const mPrice &topBid, const mPrice &topAsk) {
+      const bool unpack(const vector<mClock> &times, const vector<double> &values) {
+        const bool loaded = mVectorFromDb::unpack(times, values);
+        if (loaded) calc();
+        return loaded;
+      };
+      const vector<function<void()>> timer_1s(const mPrice &topBid, const mPrice &topAsk) {
         push_back(mStdev(fairValue, topBid, topAsk));
-        calc();
+        return calcSlices();
       };
       void calc() {
-        if (size() < 2) return;
-        fair = calc(&fairMean, "fv");
-        bid  = calc(&bidMean, "bid");
-        ask  = calc(&askMean, "ask");
-        top  = calc(&topMean, "top");
+        for (const function<void()> &slice : calcSlices()) slice();
       };
       const mMatter about() const {
         return mMatter::STDEVStats;
@@ -759,51 +966,72 @@ namespace K {
       const mClock lifetime() const {
         return 1e+3 * limit();
       };
+      const size_t width() const {
+        return 3;
+      };
+      const mClock pack(const size_t &ago, double *const values) const {
+        const mStdev &it = *(crbegin() + ago);
+        values[0] = it.fv;
+        values[1] = it.topBid;
+        values[2] = it.topAsk;
+        return Tstamp;
+      };
+      const mStdev row(const mClock &time, const double *const values) const {
+        return mStdev(values[0], values[1], values[2]);
+      };
       string explainOK() const {
         return "loaded % STDEV Periods";
       };
     private:
-      double calc(mPrice *const mean, const string &type) const {
-        vector<mPrice> values;
-        for (const mStdev &it : rows)
-          if (type == "fv")
-            values.push_back(it.fv);
-          else if (type == "bid")
-            values.push_back(it.topBid);
-          else if (type == "ask")
-            values.push_back(it.topAsk);
-          else if (type == "top") {
-            values.push_back(it.topBid);
-            values.push_back(it.topAsk);
-          }
-        return calc(mean, qp.quotingStdevProtectionFactor, values);
-      };
-      double calc(mPrice *const mean, const double &factor, const vector<mPrice> &values) const {
-        unsigned int n = values.size();
-        if (!n) return 0;
-        double sum = 0;
-        for (const mPrice &it : values) sum += it;
-        *mean = sum / n;
-        double sq_diff_sum = 0;
-        for (const mPrice &it : values) {
-          mPrice diff = it - *mean;
-          sq_diff_sum += diff * diff;
-        }
-        double variance = sq_diff_sum / n;
-        return sqrt(variance) * factor;
+      struct mSums {
+        size_t n      = 0;
+        double fair   = 0, bid   = 0, ask   = 0,
+               fairSq = 0, bidSq = 0, askSq = 0, topSq = 0;
+      };
+      const vector<function<void()>> calcSlices() {
+        vector<function<void()>> slices;
+        if (size() < 2) return slices;
+        const shared_ptr<mSums> sums = make_shared<mSums>();
+        sums->n = size();
+        for (size_t i = 0; i < sums->n; i += mChores::rows)
+          slices.push_back([&, sums, i]() {
+            const size_t end = min(min(sums->n, size()), i + mChores::rows);
+            for (size_t x = i; x < end; ++x) {
+              sums->fair += rows[x].fv;
+              sums->bid  += rows[x].topBid;
+              sums->ask  += rows[x].topAsk;
+            }
+          });
+        slices.push_back([&, sums]() {
+          const double n = sums->n;
+          fairMean = sums->fair / n;
+          bidMean  = sums->bid  / n;
+          askMean  = sums->ask  / n;
+          topMean  = (bidMean + askMean) / 2;
+        });
+        for (size_t i = 0; i < sums->n; i += mChores::rows)
+          slices.push_back([&, sums, i]() {
+            const size_t end = min(min(sums->n, size()), i + mChores::rows);
+            for (size_t x = i; x < end; ++x) {
+              sums->fairSq += pow(rows[x].fv     - fairMean, 2);
+              sums->bidSq  += pow(rows[x].topBid - bidMean,  2);
+              sums->askSq  += pow(rows[x].topAsk - askMean,  2);
+              sums->topSq  += pow(rows[x].topBid - topMean,  2)
+                            + pow(rows[x].topAsk - topMean,  2);
+            }
+          });
+        slices.push_back([&, sums]() {
+          const double n = sums->n;
+          fair = sqrt(sums->fairSq / n)       * qp.quotingStdevProtectionFactor;
+          bid  = sqrt(sums->bidSq  / n)       * qp.quotingStdevProtectionFactor;
+          ask  = sqrt(sums->askSq  / n)       * qp.quotingStdevProtectionFactor;
+          top  = sqrt(sums->topSq  / (n * 2)) * qp.quotingStdevProtectionFactor;
+        });
+        return slices;
       };
   };
   static void to_json(json &j, const mStdevs &k) {
-    j = {
-      {      "fv", k.fair    },
-      {  "fvMean", k.fairMean},
-      {    "tops", k.top     },
-      {"topsMean", k.topMean },
-      {     "bid", k.bid     },
-      { "bidMean", k.bidMean },
-      {     "ask", k.ask     },
-      { "askMean", k.askMean }
-    };
+    to_json(j, (const mStdevValues&)k);
   };
 
   struct mFairHistory: public mVectorFromDb<mPrice> {
@@ -816,44 +1044,74 @@ namespace K {
     const mClock lifetime() const {
       return 60e+3 * limit();
     };
+    const size_t width() const {
+      return 1;
+    };
+    const mClock pack(const size_t &ago, double *const values) const {
+      values[0] = *(crbegin() + ago);
+      return Tstamp;
+    };
+    const mPrice row(const mClock &time, const double *const values) const {
+      return values[0];
+    };
     string explainOK() const {
       return "loaded % historical Fair Values";
     };
   };
 
+  struct mEwmaValues {
+    mPrice mgEwmaVL = 0,
+           mgEwmaL  = 0,
+           mgEwmaM  = 0,
+           mgEwmaS  = 0,
+           mgEwmaXS = 0,
+           mgEwmaU  = 0,
+           mgEwmaP  = 0,
+           mgEwmaW  = 0;
+    double mgEwmaTrendDiff = 0;
+  };
+  static void to_json(json &j, const mEwmaValues &k) {
+    j = {
+      {  "ewmaVeryLong", k.mgEwmaVL       },
+      {      "ewmaLong", k.mgEwmaL        },
+      {    "ewmaMedium", k.mgEwmaM        },
+      {     "ewmaShort", k.mgEwmaS        },
+      {"ewmaExtraShort", k.mgEwmaXS       },
+      {"ewmaUltraShort", k.mgEwmaU        },
+      {     "ewmaQuote", k.mgEwmaP        },
+      {     "ewmaWidth", k.mgEwmaW        },
+      { "ewmaTrendDiff", k.mgEwmaTrendDiff}
+    };
+  };
   struct mEwma: public mToScreen,
-                public mStructFromDb<mEwma> {
+                public mStructFromDb<mEwma>,
+                public mEwmaValues {
     mFairHistory fairValue96h;
-          mPrice mgEwmaVL = 0,
-                 mgEwmaL  = 0,
-                 mgEwmaM  = 0,
-                 mgEwmaS  = 0,
-                 mgEwmaXS = 0,
-                 mgEwmaU  = 0,
-                 mgEwmaP  = 0,
-                 mgEwmaW  = 0;
-          double mgEwmaTrendDiff              = 0,
-                 targetPositionAutoPercentage = 0;
+          double targetPositionAutoPercentage = 0;
     private_ref:
       const mPrice &fairValue;
     public:
       mEwma(const mPrice &f)
         : fairValue(f)
       {};
-      void timer_60s(const mPrice &averageWidth) {
-        prepareHistory();
-        calcProtections(averageWidth);
-        calcPositions();
-        calcTargetPositionAutoPercentage();
-        push();
-      };
-      void calcFromHistory() {
-        if (TRUEONCE(qp._diffVLEP)) calcFromHistory(&mgEwmaVL, qp.veryLongEwmaPeriods,   "VeryLong");
-        if (TRUEONCE(qp._diffLEP))  calcFromHistory(&mgEwmaL,  qp.longEwmaPeriods,       "Long");
-        if (TRUEONCE(qp._diffMEP))  calcFromHistory(&mgEwmaM,  qp.mediumEwmaPeriods,     "Medium");
-        if (TRUEONCE(qp._diffSEP))  calcFromHistory(&mgEwmaS,  qp.shortEwmaPeriods,      "Short");
-        if (TRUEONCE(qp._diffXSEP)) calcFromHistory(&mgEwmaXS, qp.extraShortEwmaPeriods, "ExtraShort");
-        if (TRUEONCE(qp._diffUEP))  calcFromHistory(&mgEwmaU,  qp.ultraShortEwmaPeriods, "UltraShort");
+      const vector<function<void()>> timer_60s(const mPrice &averageWidth) {
+        return {
+          [&]() { prepareHistory(); },
+          [&, averageWidth]() { calcProtections(averageWidth); },
+          [&]() { calcPositions(); },
+          [&]() { calcTargetPositionAutoPercentage(); },
+          [&]() { push(); }
+        };
+      };
+      const vector<function<void()>> calcFromHistory() {
+        vector<function<void()>> slices;
+        if (TRUEONCE(qp._diffVLEP)) calcFromHistory(slices, &mgEwmaVL, qp.veryLongEwmaPeriods,   "VeryLong");
+        if (TRUEONCE(qp._diffLEP))  calcFromHistory(slices, &mgEwmaL,  qp.longEwmaPeriods,       "Long");
+        if (TRUEONCE(qp._diffMEP))  calcFromHistory(slices, &mgEwmaM,  qp.mediumEwmaPeriods,     "Medium");
+        if (TRUEONCE(qp._diffSEP))  calcFromHistory(slices, &mgEwmaS,  qp.shortEwmaPeriods,      "Short");
+        if (TRUEONCE(qp._diffXSEP)) calcFromHistory(slices, &mgEwmaXS, qp.extraShortEwmaPeriods, "ExtraShort");
+        if (TRUEONCE(qp._diffUEP))  calcFromHistory(slices, &mgEwmaU,  qp.ultraShortEwmaPeriods, "UltraShort");
+        return slices;
       };
       const mMatter about() const {
         return mMatter::EWMAStats;
@@ -883,13 +1141,20 @@ namespace K {
       void prepareHistory() {
         fairValue96h.push_back(fairValue);
       };
-      void calcFromHistory(mPrice *const mean, const unsigned int &periods, const string &name) {
-        unsigned int n = fairValue96h.size();
-        if (!n--) return;
-        unsigned int x = 0;
-        *mean = fairValue96h.front();
-        while (n--) calc(mean, periods, fairValue96h.at(++x));
-        print("MG", "reloaded " + to_string(*mean) + " EWMA " + name);
+      void calcFromHistory(vector<function<void()>> &slices, mPrice *const mean, const unsigned int periods, const string &name) {
+        const size_t n = fairValue96h.size();
+        if (!n) return;
+        const shared_ptr<mPrice> value = make_shared<mPrice>(fairValue96h.front());
+        for (size_t i = 1; i < n; i += mChores::rows)
+          slices.push_back([&, value, periods, n, i]() {
+            const size_t end = min(min(n, fairValue96h.size()), i + mChores::rows);
+            for (size_t x = i; x < end; ++x)
+              calc(value.get(), periods, fairValue96h.at(x));
+          });
+        slices.push_back([&, mean, value, name]() {
+          *mean = *value;
+          print("MG", "reloaded " + to_string(*mean) + " EWMA " + name);
+        });
       };
       void calcPositions() {
         calc(&mgEwmaVL, qp.veryLongEwmaPeriods,   fairValue);
@@ -925,17 +1190,7 @@ namespace K {
       };
   };
   static void to_json(json &j, const mEwma &k) {
-    j = {
-      {  "ewmaVeryLong", k.mgEwmaVL       },
-      {      "ewmaLong", k.mgEwmaL        },
-      {    "ewmaMedium", k.mgEwmaM        },
-      {     "ewmaShort", k.mgEwmaS        },
-      {"ewmaExtraShort", k.mgEwmaXS       },
-      {"ewmaUltraShort", k.mgEwmaU        },
-      {     "ewmaQuote", k.mgEwmaP        },
-      {     "ewmaWidth", k.mgEwmaW        },
-      { "ewmaTrendDiff", k.mgEwmaTrendDiff}
-    };
+    to_json(j, (const mEwmaValues&)k);
   };
   static void from_json(const json &j, mEwma &k) {
     k.mgEwmaVL = j.value("ewmaVeryLong", 0.0);
@@ -946,6 +1201,22 @@ namespace K {
     k.mgEwmaU  = j.value("ewmaUltraShort", 0.0);
   };
 
+  struct mMarketChart {
+     mEwmaValues ewma;
+    mStdevValues stdev;
+          mPrice fairValue         = 0;
+         mAmount takersBuySize60s  = 0,
+                 takersSellSize60s = 0;
+  };
+  static void to_json(json &j, const mMarketChart &k) {
+    j = {
+      {          "ewma", k.ewma             },
+      {    "stdevWidth", k.stdev            },
+      {     "fairValue", k.fairValue        },
+      { "tradesBuySize", k.takersBuySize60s },
+      {"tradesSellSize", k.takersSellSize60s}
+    };
+  };
   struct mMarketStats: public mJsonToClient<mMarketStats> {
                mEwma ewma;
              mStdevs stdev;
@@ -962,15 +1233,21 @@ namespace K {
     const bool realtime() const {
       return !qp.delayUI;
     };
+    const mMarketChart chart() const {
+      mMarketChart k;
+      k.ewma              = ewma;
+      k.stdev             = stdev;
+      k.fairValue         = fairPrice.currentPrice();
+      k.takersBuySize60s  = takerTrades.takersBuySize60s;
+      k.takersSellSize60s = takerTrades.takersSellSize60s;
+      return k;
+    };
+    const function<const string()> snapshot() const {
+      return later(chart());
+    };
   };
   static void to_json(json &j, const mMarketStats &k) {
-    j = {
-      {          "ewma", k.ewma                         },
-      {    "stdevWidth", k.stdev                        },
-      {     "fairValue", k.fairPrice.currentPrice()     },
-      { "tradesBuySize", k.takerTrades.takersBuySize60s },
-      {"tradesSellSize", k.takerTrades.takersSellSize60s}
-    };
+    to_json(j, k.chart());
   };
 
   struct mProduct: public mJsonToClient<mProduct> {
@@ -981,6 +1258,9 @@ namespace K {
     const mMatter about() const {
       return mMatter::ProductAdvertisement;
     };
+    const function<const string()> snapshot() const {
+      return later(*this);
+    };
   };
   static void to_json(json &j, const mProduct &k) {
     j = {
@@ -1021,6 +1301,15 @@ namespace K {
         unfilter();
         return mToClient::hello();
       };
+      const function<const string()> snapshot() const {
+        const mLevels levels = *this;
+        const bool patched_ = patched;
+        return [levels, patched_]() {
+          json j = levels;
+          if (patched_) j["diff"] = true;
+          return j.dump();
+        };
+      };
     private:
       const bool ratelimit() {
         return unfiltered.empty() or empty()
@@ -1088,13 +1377,14 @@ namespace K {
         if (err) stats.fairPrice.warn("QE", "Unable to calculate quote, missing market data");
         return err;
       };
-      void timer_1s() {
-        stats.stdev.timer_1s(bids.cbegin()->price, asks.cbegin()->price);
+      const vector<function<void()>> timer_1s() {
+        return stats.stdev.timer_1s(bids.cbegin()->price, asks.cbegin()->price);
       };
-      void timer_60s() {
-        stats.takerTrades.timer_60s();
-        stats.ewma.timer_60s(resetAverageWidth());
-        stats.send();
+      const vector<function<void()>> timer_60s() {
+        vector<function<void()>> slices = stats.ewma.timer_60s(resetAverageWidth());
+        slices.insert(slices.begin(), [&]() { stats.takerTrades.timer_60s(); });
+        slices.push_back([&]() { stats.send(); });
+        return slices;
       };
       const mPrice calcQuotesWidth(bool *const superSpread) const {
         const mPrice widthPing = fmax(
@@ -1227,9 +1517,10 @@ namespace K {
       return mMatter::Profit;
     };
     void erase() {
-      for (vector<mProfit>::iterator it = begin(); it != end();)
-        if (it->time + lifetime() > Tstamp) ++it;
-        else it = rows.erase(it);
+      const mClock expire = Tstamp - lifetime();
+      rows.erase(begin(), find_if(begin(), end(), [&](const mProfit &it) {
+        return it.time > expire;
+      }));
     };
     const double limit() const {
       return qp.profitHourInterval;
@@ -1237,6 +1528,20 @@ namespace K {
     const mClock lifetime() const {
       return 3600e+3 * limit();
     };
+    const size_t width() const {
+      return 2;
+    };
+    const mClock pack(const size_t &ago, double *const values) const {
+      const mProfit &it = *(crbegin() + ago);
+      values[0] = it.baseValue;
+      values[1] = it.quoteValue;
+      return it.time;
+    };
+    const mProfit row(const mClock &time, const double *const values) const {
+      mProfit profit(values[0], values[1]);
+      profit.time = time;
+      return profit;
+    };
     string explainOK() const {
       return "loaded % historical Profits";
     };
@@ -1327,6 +1632,10 @@ namespace K {
       if (crbegin()->Kqty == -1) return nullptr;
       else return mVectorFromDb::blob();
     };
+    const function<const string()> snapshot() const {
+      if (crbegin()->Kqty == -1) return later(nullptr);
+      else return later(back());
+    };
     const string increment() const {
       return crbegin()->tradeId;
     };
@@ -1845,6 +2154,9 @@ namespace K {
     const mMatter about() const {
       return mMatter::Notepad;
     };
+    const function<const string()> snapshot() const {
+      return later(content);
+    };
   };
   static void to_json(json &j, const mNotepad &k) {
     j = k.content;
@@ -1895,6 +2207,9 @@ namespace K {
       const mMatter about() const {
         return mMatter::Connectivity;
       };
+      const function<const string()> snapshot() const {
+        return later(*this);
+      };
     private:
       void send_refresh() {
         const mConnectivity k = greenGateway * adminAgreement;
@@ -2246,7 +2561,7 @@ namespace K {
           } else if (qp.safety != mQuotingSafety::AK47
             or quote.deprecates(order.price)
           ) {
-            if (args->num("lifetime") and order.time + args->num("lifetime") > Tstamp)
+            if (args->num("lifetime") and !order.mature)
               quote.skip();
             else return true;
           }
@@ -2269,7 +2584,7 @@ namespace K {
       };
       const bool stillAlive(const mOrder &order) {
         if (order.status == mStatus::Waiting) {
-          if (Tstamp - 10e+3 > order.time) {
+          if (order.zombie) {
             zombies.push_back(&order);
             return false;
           }
@@ -2567,16 +2882,15 @@ namespace K {
       };
   };
 
-  struct mMonitor: public mJsonToClient<mMonitor> {
-    unsigned int /* ( | L | ) */ /* more */ orders_60s /* ? */;
-    const string /*  )| O |(  */  * unlock;
-        mProduct /* ( | C | ) */ /* this */ product;
-                 /*  )| K |(  */ /* thanks! <3 */
-    mMonitor()
-      : orders_60s(0)
-      , unlock(nullptr)
-    {};
-    const unsigned int memSize() const {
+  struct mMonitorState {
+          string unlock;
+    unsigned int orders_60s = 0;
+            json budget,
+                 gaps,
+                 legs,
+                 clients;
+    function<json()> storage;
+    static const unsigned int memSize() {
 #ifdef _WIN32
       return 0;
 #else
@@ -2584,31 +2898,68 @@ namespace K {
       return getrusage(RUSAGE_SELF, &ru) ? 0 : ru.ru_maxrss * 1e+3;
 #endif
     };
-    const unsigned int dbSize() const {
+    static const unsigned int dbSize() {
       if (args->str("database") == ":memory:") return 0;
       struct stat st;
       return stat(args->str("database").data(), &st) ? 0 : st.st_size;
     };
+  };
+  static void to_json(json &j, const mMonitorState &k) {
+    j = {
+      {     "a", k.unlock                                          },
+      {  "inet", string(mREST::inet ?: "")                         },
+      {  "freq", k.orders_60s                                      },
+      { "theme", args->num("ignore-moon") + args->num("ignore-sun")},
+      {"memory", k.memSize()                                       },
+      {"dbsize", k.dbSize()                                        },
+      {  "rest", mREST::stats()                                    },
+      {"budget", k.budget                                          },
+      {  "gaps", k.gaps                                            },
+      {  "legs", k.legs                                            },
+      {"thread", topology.stats()                                  },
+      {    "db", k.storage ? k.storage() : json::object()          },
+      {    "ui", k.clients                                         }
+    };
+  };
+  struct mMonitor: public mJsonToClient<mMonitor> {
+    unsigned int /* ( | L | ) */ /* more */ orders_60s /* ? */;
+    const string /*  )| O |(  */  * unlock;
+        mProduct /* ( | C | ) */ /* this */ product;
+                 /*  )| K |(  */ /* thanks! <3 */
+    function<json()> storage,
+                     clients;
+    mMonitor()
+      : orders_60s(0)
+      , unlock(nullptr)
+    {};
     void tick_orders() {
       orders_60s++;
     };
     void timer_60s() {
+      if (gw) gw->lifecycle.roll();
       send();
       orders_60s = 0;
     };
     const mMatter about() const {
       return mMatter::ApplicationState;
     };
+    const mMonitorState state() const {
+      mMonitorState k;
+      k.unlock     = *unlock;
+      k.orders_60s = orders_60s;
+      k.budget     = gw ? gw->budget.stats() : json::object();
+      k.gaps       = gw ? gw->failover.stats() : json::object();
+      k.legs       = gw ? gw->lifecycle.last() : json::object();
+      k.clients    = clients ? clients() : json::array();
+      k.storage    = storage;
+      return k;
+    };
+    const function<const string()> snapshot() const {
+      return later(state());
+    };
   };
   static void to_json(json &j, const mMonitor &k) {
-    j = {
-      {     "a", *k.unlock                                         },
-      {  "inet", string(mREST::inet ?: "")                         },
-      {  "freq", k.orders_60s                                      },
-      { "theme", args->num("ignore-moon") + args->num("ignore-sun")},
-      {"memory", k.memSize()                                       },
-      {"dbsize", k.dbSize()                                        }
-    };
+    to_json(j, k.state());
   };
 }
 
@@ -7,13 +7,19 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <fstream>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <array>
+#include <deque>
 #include <unordered_map>
 #include <map>
 #include <random>
 #include <thread>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
 #include <future>
 #include <chrono>
 #include <locale>
@@ -23,11 +29,15 @@
 #include <signal.h>
 #include <algorithm>
 #include <functional>
+#include <memory>
 
 #ifdef _WIN32
 #define strsignal to_string
 #else
 #include <execinfo.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/select.h>
 #include <sys/resource.h>
 #endif
 
@@ -41,6 +51,7 @@ using namespace std;
 #include <openssl/bio.h>
 #include <openssl/evp.h>
 #include <openssl/sha.h>
+#include <openssl/ssl.h>
 #include <openssl/hmac.h>
 #include <openssl/buffer.h>
 #include <ncurses/ncurses.h>
@@ -64,9 +75,8 @@ using namespace nlohmann;
 #define mCoinId string
 
 #define Tclock  chrono::system_clock::now()
-#define Tstamp  chrono::duration_cast<chrono::milliseconds>( \
-                  Tclock.time_since_epoch()                  \
-                ).count()
+#define Tstamp  clockwork.stamp()
+#define Tsteady clockwork.precise()
 
 #define numsAz "0123456789"                 \
                "ABCDEFGHIJKLMNOPQRSTUVWXYZ" \
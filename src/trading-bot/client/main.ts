@@ -654,7 +654,7 @@ class DisplayOrder {
     </div>
     <address class="text-center">
       <small>
-        <a href="{{ homepage }}/blob/master/README.md" target="_blank">README</a> - <a href="{{ homepage }}/blob/master/doc/MANUAL.md" target="_blank">MANUAL</a> - <a href="{{ homepage }}" target="_blank">SOURCE</a> - <span [hidden]="!ready"><span [hidden]="!inet"><span title="non-default Network Interface for outgoing traffic">{{ inet }}</span> - </span><span title="Server used RAM" style="margin-top: 6px;display: inline-block;">{{ server_memory }}</span> - <span title="Client used RAM" style="margin-top: 6px;display: inline-block;">{{ client_memory }}</span> - <span title="Database Size" style="margin-top: 6px;display: inline-block;">{{ db_size }}</span> - <span title="Pings in memory" style="margin-top: 6px;display: inline-block;">{{ tradesLength }}</span> - <span title="Market Levels in memory (bids|asks)" style="margin-top: 6px;display: inline-block;">{{ bidsLength }}|{{ asksLength }}</span> - </span><a href="#" (click)="openMatryoshka()">MATRYOSHKA</a> - <a href="{{ homepage }}/issues/new?title=%5Btopic%5D%20short%20and%20sweet%20description&body=description%0Aplease,%20consider%20to%20add%20all%20possible%20details%20%28if%20any%29%20about%20your%20new%20feature%20request%20or%20bug%20report%0A%0A%2D%2D%2D%0A%60%60%60%0Aapp%20exchange%3A%20{{ exchange_name }}/{{ baseCurrency+'/'+quoteCurrency }}%0Aapp%20version%3A%20undisclosed%0AOS%20distro%3A%20undisclosed%0A%60%60%60%0A![300px-spock_vulcan-salute3](https://cloud.githubusercontent.com/assets/1634027/22077151/4110e73e-ddb3-11e6-9d84-358e9f133d34.png)" target="_blank">CREATE ISSUE</a> - <a href="https://earn.com/analpaper/" target="_blank">HELP</a> - <a title="irc://irc.freenode.net:6697/#tradingBot" href="irc://irc.freenode.net:6697/#tradingBot">IRC</a>|<a target="_blank" href="https://kiwiirc.com/client/irc.freenode.net:6697/?theme=cli#tradingBot" rel="nofollow">www</a>
+        <a href="{{ homepage }}/blob/master/README.md" target="_blank">README</a> - <a href="{{ homepage }}/blob/master/doc/MANUAL.md" target="_blank">MANUAL</a> - <a href="{{ homepage }}" target="_blank">SOURCE</a> - <span [hidden]="!ready"><span [hidden]="!inet"><span title="non-default Network Interface for outgoing traffic">{{ inet }}</span> - </span><span title="Server used RAM" style="margin-top: 6px;display: inline-block;">{{ server_memory }}</span> - <span title="Client used RAM" style="margin-top: 6px;display: inline-block;">{{ client_memory }}</span> - <span title="Database Size" style="margin-top: 6px;display: inline-block;">{{ db_size }}</span> - <span [hidden]="!rest_pool"><span title="REST connections reused and average latency per host" style="margin-top: 6px;display: inline-block;">{{ rest_pool }}</span> - </span><span [hidden]="!rest_budget"><span title="REST rate limit tokens available and throttled polls" style="margin-top: 6px;display: inline-block;">{{ rest_budget }}</span> - </span><span [hidden]="!ws_gaps"><span title="WSS drops and last/worst gap until quoting resumed" style="margin-top: 6px;display: inline-block;">{{ ws_gaps }}</span> - </span><span [hidden]="!order_legs"><span title="Order lifecycle p50/p99 in the last minute: our queue, gateway hand-off, exchange ack and cancel ack" style="margin-top: 6px;display: inline-block;">{{ order_legs }}</span> - </span><span [hidden]="!thread_cpu"><span title="CPU time spent by each thread role (* pinned, ! realtime)" style="margin-top: 6px;display: inline-block;">{{ thread_cpu }}</span> - </span><span [hidden]="!db_commit"><span title="Database writes pending, and p50/p99 of each group commit" style="margin-top: 6px;display: inline-block;">{{ db_commit }}</span> - </span><span [hidden]="!ui_buffer"><span title="Bytes buffered to UI connections and market data coalesced for slow ones" style="margin-top: 6px;display: inline-block;">{{ ui_buffer }}</span> - </span><span title="Pings in memory" style="margin-top: 6px;display: inline-block;">{{ tradesLength }}</span> - <span title="Market Levels in memory (bids|asks)" style="margin-top: 6px;display: inline-block;">{{ bidsLength }}|{{ asksLength }}</span> - </span><a href="#" (click)="openMatryoshka()">MATRYOSHKA</a> - <a href="{{ homepage }}/issues/new?title=%5Btopic%5D%20short%20and%20sweet%20description&body=description%0Aplease,%20consider%20to%20add%20all%20possible%20details%20%28if%20any%29%20about%20your%20new%20feature%20request%20or%20bug%20report%0A%0A%2D%2D%2D%0A%60%60%60%0Aapp%20exchange%3A%20{{ exchange_name }}/{{ baseCurrency+'/'+quoteCurrency }}%0Aapp%20version%3A%20undisclosed%0AOS%20distro%3A%20undisclosed%0A%60%60%60%0A![300px-spock_vulcan-salute3](https://cloud.githubusercontent.com/assets/1634027/22077151/4110e73e-ddb3-11e6-9d84-358e9f133d34.png)" target="_blank">CREATE ISSUE</a> - <a href="https://earn.com/analpaper/" target="_blank">HELP</a> - <a title="irc://irc.freenode.net:6697/#tradingBot" href="irc://irc.freenode.net:6697/#tradingBot">IRC</a>|<a target="_blank" href="https://kiwiirc.com/client/irc.freenode.net:6697/?theme=cli#tradingBot" rel="nofollow">www</a>
       </small>
     </address>
     <iframe id="matryoshka" style="margin:0px;padding:0px;border:0px;width:100%;height:0px;" src="about:blank"></iframe>
@@ -669,6 +669,13 @@ class ClientComponent implements OnInit {
   public client_memory: string;
   public inet: string = "";
   public db_size: string;
+  public rest_pool: string;
+  public rest_budget: string;
+  public ws_gaps: string;
+  public order_legs: string;
+  public thread_cpu: string;
+  public db_commit: string;
+  public ui_buffer: string;
   public notepad: string;
   public ready: boolean;
   public showSettings: boolean = true;
@@ -928,6 +935,14 @@ class ClientComponent implements OnInit {
     this.server_memory = this.bytesToSize(o.memory, 0);
     this.client_memory = this.bytesToSize((<any>window.performance).memory ? (<any>window.performance).memory.usedJSHeapSize : 1, 0);
     this.db_size = this.bytesToSize(o.dbsize, 0);
+    this.rest_pool = Object.keys(o.rest || {}).map(x => o.rest[x].reuse.toFixed(0) + '%/' + o.rest[x].latency.toFixed(0) + 'ms').join(' ');
+    const throttled = o.budget ? Object.keys(o.budget.endpoints || {}).reduce((a, x) => a + o.budget.endpoints[x].throttled, 0) : 0;
+    this.rest_budget = o.budget && o.budget.burst ? o.budget.tokens + '/' + o.budget.burst + ' req' + (throttled ? ' (' + throttled + ' throttled)' : '') : null;
+    this.ws_gaps = o.gaps && o.gaps.drops ? o.gaps.drops + ' drops ' + o.gaps.last + '/' + o.gaps.worst + 'ms' : null;
+    this.order_legs = ['queue', 'gateway', 'ack', 'cancel'].filter(x => o.legs && o.legs[x] && o.legs[x].count).map(x => x + ' ' + (o.legs[x].p50 / 1e3).toFixed(1) + '/' + (o.legs[x].p99 / 1e3).toFixed(1) + 'ms').join(' ') || null;
+    this.thread_cpu = Object.keys(o.thread || {}).map(x => x + (o.thread[x].pinned ? '*' : '') + (o.thread[x].realtime ? '!' : '') + ' ' + (o.thread[x].cpu / 1e3).toFixed(1) + 's').join(' ') || null;
+    this.db_commit = o.db && o.db.commits ? o.db.queue + ' queued ' + (o.db.commit.p50 / 1e3).toFixed(1) + '/' + (o.db.commit.p99 / 1e3).toFixed(1) + 'ms' : null;
+    this.ui_buffer = o.ui && o.ui.length ? o.ui.map(x => x.buffered).reduce((a, b) => a + b, 0) + 'B buffered ' + o.ui.map(x => x.dropped).reduce((a, b) => a + b, 0) + ' dropped' : null;
     this.tradeFreq = (o.freq);
     this.user_theme = this.user_theme!==null ? this.user_theme : (o.theme==1 ? '' : (o.theme==2 ? '-dark' : this.user_theme));
     this.system_theme = this.getTheme((new Date).getHours());
@@ -251,7 +251,7 @@ export class ProductAdvertisement {
 }
 
 export class ApplicationState {
-    constructor(public memory: number, public inet: string, public freq: number, public theme: number, public dbsize: number) { }
+    constructor(public memory: number, public inet: string, public freq: number, public theme: number, public dbsize: number, public rest: any, public budget: any, public gaps: any, public legs: any, public thread: any, public db: any, public ui: any) { }
 }
 
 export class TradeSafety {
@@ -5,62 +5,192 @@ namespace K {
   class DB: public Klass,
             public Sqlite { public: DB() { sqlite = this; };
     private:
+      struct mStatements {
+        sqlite3_stmt *insert   = nullptr,
+                     *erase    = nullptr,
+                     *truncate = nullptr,
+                     *clear    = nullptr,
+                     *select   = nullptr;
+      };
       sqlite3 *db = nullptr;
-      string qpdb = "main";
+      string qpdb = "main",
+             failure;
+      unordered_map<mMatter, mStatements> statements;
+      unordered_map<mMatter, mSeries> series;
+      unordered_map<string, mHistogram> timings;
+      mJournal journal;
+      mutex io,
+            timing;
     protected:
       void load() {
         if (sqlite3_open(options.str("database").data(), &db))
           error("DB", sqlite3_errmsg(db));
+        exec(pragmas("main"));
         screen->log("DB", "loaded OK from", options.str("database"));
         if (options.str("diskdata").empty()) return;
         qpdb = "qpdb";
         exec("ATTACH '" + options.str("diskdata") + "' AS " + qpdb + ";");
+        exec(pragmas(qpdb));
         screen->log("DB", "loaded OK from", options.str("diskdata"));
       };
+      void run() {
+        topology.pin("db", options.str("cpu-db"));
+        journal.commit = [&](const vector<function<void()>> &batch) {
+          string reason;
+          {
+            lock_guard<mutex> lock(io);
+            query("BEGIN;");
+            for (const function<void()> &it : batch) it();
+            query("COMMIT;");
+            reason.swap(failure);
+          }
+          if (!reason.empty()) events->deferred([reason]() {
+            screen->logWar("DB", reason);
+          });
+        };
+        journal.start(options.num("db-commit"), options.num("db-queue"));
+        engine->monitor.storage = [&]() {
+          json stats = journal.stats();
+          stats["statements"] = json::object();
+          lock_guard<mutex> lock(timing);
+          for (const unordered_map<string, mHistogram>::value_type &it : timings)
+            stats["statements"][it.first] = it.second.stats();
+          return stats;
+        };
+      };
+      void end() {
+        journal.stop();
+      };
     public:
       void backup(mFromDb *const data) {
-        const bool loaded = data->pull(select(data));
+        prepare(data);
+        const bool loaded = data->width()
+          ? load(data)
+          : data->pull(select(data));
         const string msg = data->explanation(loaded);
-        data->push = [this, data]() { insert(data); };
+        data->push = [this, data]() {
+          if (data->width()) append(data);
+          else insert(data);
+        };
         if (msg.empty()) return;
         if (loaded) screen->log("DB", msg);
         else screen->logWar("DB", msg);
       };
     private:
       json select(mFromDb *const data) {
-        const string table = schema(data->about());
+        const mStatements &it = statements.at(data->about());
         json result = json::array();
-        exec(
-          create(table)
-          + truncate(table, data->lifetime())
-          + "SELECT json FROM " + table + " ORDER BY time ASC;",
-          &result
-        );
+        string reason;
+        {
+          lock_guard<mutex> lock(io);
+          if (data->lifetime()) {
+            sqlite3_bind_int64(it.truncate, 1, Tstamp - data->lifetime());
+            reason = step(it.truncate, "truncate");
+          }
+          if (reason.empty()) reason = step(it.select, "select", [&]() {
+            result.push_back(json::parse(string(
+              (const char*)sqlite3_column_blob(it.select, 0),
+              sqlite3_column_bytes(it.select, 0)
+            )));
+          });
+        }
+        if (!reason.empty()) screen->logWar("DB", reason);
         return result;
       };
       void insert(mFromDb *const data) {
-        const string  table    = schema(data->about());
-        const json    blob     = data->blob();
-        const double  limit    = data->limit();
-        const mClock  lifetime = data->lifetime();
-        const string  incr     = data->increment();
-        const string  sql      = (
-          (incr != "NULL" or !limit or lifetime)
-            ? "DELETE FROM " + table + (
-              incr != "NULL"
-                ? " WHERE id = " + incr
-                : (limit ? " WHERE time < " + to_string(Tstamp - lifetime) : "")
-            ) + ";" : ""
-        ) + (
-          blob.is_null()
-            ? ""
-            : "INSERT INTO " + table
-              + " (id,json) VALUES(" + incr + ",'" + blob.dump() + "');"
-        );
-        events->deferred([this, sql]() {
-          exec(sql);
+        const mStatements            &it       = statements.at(data->about());
+        const shared_ptr<const json>  blob     = make_shared<const json>(data->blob());
+        const double                  limit    = data->limit();
+        const mClock                  lifetime = data->lifetime(),
+                                      before   = Tstamp - lifetime;
+        const string                  incr     = data->increment();
+        journal.push([this, &it, blob, limit, lifetime, before, incr]() {
+          if (incr != "NULL") {
+            sqlite3_bind_text(it.erase, 1, incr.data(), incr.length(), SQLITE_STATIC);
+            failed(step(it.erase, "erase"));
+          } else if (limit) {
+            if (lifetime) {
+              sqlite3_bind_int64(it.truncate, 1, before);
+              failed(step(it.truncate, "truncate"));
+            }
+          } else failed(step(it.clear, "clear"));
+          if (blob->is_null()) return;
+          const string row = blob->dump();
+          if (incr != "NULL")
+            sqlite3_bind_text(it.insert, 1, incr.data(), incr.length(), SQLITE_STATIC);
+          sqlite3_bind_blob(it.insert, 2, row.data(), row.length(), SQLITE_STATIC);
+          failed(step(it.insert, "insert"));
+        });
+      };
+      const bool load(mFromDb *const data) {
+        string reason;
+        bool loaded;
+        {
+          lock_guard<mutex> lock(io);
+          loaded = series.at(data->about()).load(cutoff(data), reason);
+        }
+        if (!reason.empty()) screen->logWar("DB", reason);
+        return loaded;
+      };
+      void append(mFromDb *const data) {
+        mSeries &it = series.at(data->about());
+        vector<double> row(data->width());
+        const mClock time   = data->pack(0, row.data()),
+                     before = cutoff(data);
+        journal.push([this, &it, time, row, before]() {
+          failed(it.append(time, row.data(), before));
         });
       };
+      const mClock cutoff(mFromDb *const data) const {
+        return data->lifetime() ? Tstamp - data->lifetime() : 0;
+      };
+      void prepare(mFromDb *const data) {
+        const mMatter type = data->about();
+        if (statements.find(type) != statements.end()) return;
+        const string table = schema(type);
+        exec(create(table));
+        string reason;
+        {
+          lock_guard<mutex> lock(io);
+          mStatements &it = statements[type];
+          it.insert   = prepare("INSERT INTO " + table + " (id,json) VALUES(?1,?2);");
+          it.erase    = prepare("DELETE FROM " + table + " WHERE id = ?1;");
+          it.truncate = prepare("DELETE FROM " + table + " WHERE time < ?1;");
+          it.clear    = prepare("DELETE FROM " + table + ";");
+          it.select   = prepare("SELECT json FROM " + table + " ORDER BY time ASC;");
+          if (!data->width()) return;
+          mSeries &k = series[type];
+          k.step = [this](sqlite3_stmt *const stmt, const string &name, const function<void()> &row) {
+            return step(stmt, name, row);
+          };
+          reason = k.open(db, data, table);
+        }
+        if (!reason.empty()) screen->logWar("DB", reason);
+      };
+      sqlite3_stmt *prepare(const string &sql) {
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(db, sql.data(), sql.length() + 1, &stmt, nullptr) != SQLITE_OK)
+          screen->logWar("DB", "SQLite error: " + (sqlite3_errmsg(db) + (" at " + sql)));
+        return stmt;
+      };
+      const string step(sqlite3_stmt *const stmt, const string &name, const function<void()> &row = nullptr) {
+        const mClock began = Tsteady;
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+          if (row) row();
+        const string reason = rc == SQLITE_DONE
+          ? ""
+          : "SQLite error: " + (sqlite3_errmsg(db) + (" at " + string(sqlite3_sql(stmt) ?: "")));
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        const mClock spent = Tsteady - began;
+        lock_guard<mutex> lock(timing);
+        timings[name].record(spent);
+        return reason;
+      };
+      void failed(const string &reason) {
+        if (failure.empty()) failure = reason;
+      };
       string schema(const mMatter &type) {
         return (type == mMatter::QuotingParameters ? qpdb : "main") + "." + (char)type;
       };
@@ -70,22 +200,27 @@ namespace K {
           + "json  BLOB                                                                          NOT NULL,"
           + "time  TIMESTAMP DEFAULT (CAST((julianday('now') - 2440587.5)*86400000 AS INTEGER))  NOT NULL);";
       };
-      string truncate(const string &table, const mClock &lifetime) {
-        return lifetime
-          ? "DELETE FROM " + table + " WHERE time < " + to_string(Tstamp - lifetime) + ";"
-          : "";
+      string pragmas(const string &schema) {
+        return "PRAGMA " + schema + ".journal_mode = WAL;"
+             + "PRAGMA " + schema + ".synchronous  = NORMAL;";
       };
-      void exec(const string &sql, json *const result = nullptr) {
+      void exec(const string &sql) {
+        string reason;
+        {
+          lock_guard<mutex> lock(io);
+          reason = query(sql);
+        }
+        if (!reason.empty()) screen->logWar("DB", reason);
+      };
+      const string query(const string &sql) {
         // screen->log("DB DEBUG", sql);
         char* zErrMsg = 0;
-        sqlite3_exec(db, sql.data(), result ? write : nullptr, (void*)result, &zErrMsg);
-        if (zErrMsg) screen->logWar("DB", "SQLite error: " + (zErrMsg + (" at " + sql)));
+        sqlite3_exec(db, sql.data(), nullptr, nullptr, &zErrMsg);
+        const string reason = zErrMsg
+          ? "SQLite error: " + (zErrMsg + (" at " + sql))
+          : "";
         sqlite3_free(zErrMsg);
-      };
-      static int write(void *result, int argc, char **argv, char **azColName) {
-        for (int i = 0; i < argc; ++i)
-          ((json*)result)->push_back(json::parse(argv[i]));
-        return 0;
+        return reason;
       };
   };
 }
@@ -8,13 +8,14 @@ namespace K  {
       uWS::Hub  *socket = nullptr;
       uS::Timer *timer  = nullptr;
       uS::Async *loop   = nullptr;
-      vector<function<void()>> slowFn;
-      unsigned int tick = 0;
+      mQueue<function<void()>> slowFn;
+      bool rearm = false;
     protected:
       void load() {
         socket = new uWS::Hub(0, true);
       };
       void waitData() {
+        mREST::loop(socket->getLoop());
         gw->socket = socket;
         socket->createGroup<uWS::CLIENT>();
       };
@@ -26,14 +27,24 @@ namespace K  {
       void waitTime() {
         timer = new uS::Timer(socket->getLoop());
         timer->setData(this);
-        timer->start([](uS::Timer *timer) {
-          ((EV*)timer->getData())->timer_1s();
-        }, 0, 1e+3);
+        timeline.every(1e+3, [&]() {
+          timer_1s();
+        });
+        gw->askForData();
+        alarm();
       };
       void run() {
+        topology.join("loop");
         loop = new uS::Async(socket->getLoop());
         loop->setData(this);
         loop->start(walk);
+        timeline.wakeup = [&]() {
+          rearm = true;
+          loop->send();
+        };
+        gw->workers.wakeup = [&]() {
+          loop->send();
+        };
       };
       void end() {
         timer->stop();
@@ -45,32 +56,37 @@ namespace K  {
       };
     public:
       void deferred(const function<void()> &fn) {
-        slowFn.push_back(fn);
-        loop->send();
+        slowFn.push(fn);
+        if (loop) loop->send();
       };
     private:
       void deferred() {
-        if (slowFn.empty()) return;
-        for (function<void()> &it : slowFn) it();
-        slowFn.clear();
+        function<void()> fn;
+        while (slowFn.pop(fn)) fn();
       };
       void (*walk)(uS::Async *const) = [](uS::Async *const loop) {
+        clockwork.tick();
         ((EV*)loop->getData())->deferred();
-        if (gw->waitForData()) loop->send();
-        screen->waitForUser();
+        if (TRUEONCE(((EV*)loop->getData())->rearm))
+          ((EV*)loop->getData())->alarm();
+        gw->waitForData();
+        if (chores.run(options.num("loop-budget")))
+          loop->send();
+        clockwork.tock();
+      };
+      void alarm() {
+        timer->stop();
+        timer->start([](uS::Timer *timer) {
+          clockwork.tick();
+          timeline.advance();
+          clockwork.tock();
+          ((EV*)timer->getData())->alarm();
+          ((EV*)timer->getData())->loop->send();
+        }, timeline.idle(), 0);
       };
       void timer_1s() {
-        if (!gw->countdown)                  engine->timer_1s(tick);
-        else if (!--gw->countdown) {         gw->connect();
-          tick = 0;
-          return;
-        }
-        if (                                 gw->askForData(tick)
-        ) loop->send();
-        if (client->socket and qp.delayUI
-          and !(tick % qp.delayUI))          client->timer_Xs();
-        if (++tick >= 300 * (qp.delayUI?:1))
-          tick = 0;
+        if (!gw->countdown)        engine->timer_1s();
+        else if (!--gw->countdown) gw->connect();
       };
   };
 }
@@ -8,6 +8,10 @@ namespace K {
         {"wallet-limit", "AMOUNT", "0",                        "set AMOUNT in base currency to limit the balance,"
                                                                "\n" "otherwise the full available balance can be used"},
         {"client-limit", "NUMBER", "7",                        "set NUMBER of maximum concurrent UI connections"},
+        {"client-bytes", "NUMBER", "1048576",                  "set NUMBER of maximum bytes buffered per UI connection,"
+                                                               "\n" "market data is coalesced while a slow client is over it"},
+        {"client-lag",   "NUMBER", "30000",                    "set NUMBER of milliseconds a slow UI connection may stay"
+                                                               "\n" "over '--client-bytes' before it is disconnected"},
         {"naked",        "1",      0,                          "do not display CLI, print output to stdout instead"},
         {"headless",     "1",      0,                          "do not listen for UI connections,"
                                                                "\n" "all other UI related arguments will be ignored"},
@@ -23,17 +27,29 @@ namespace K {
                                                                "\n" "mandatory but may be 'NULL'"},
         {"pass",         "WORD",   "NULL",                     "set allowed WORD as password for UI connections,"
                                                                "\n" "mandatory but may be 'NULL'"},
+        {"cpu-ui",       "LIST",   "",                         "set LIST of cpus to pin the thread of UI encoding and broadcast"},
         {"database",     "FILE",   "",                         "set alternative PATH to database filename,"
                                                                "\n" "default PATH is '/data/db/K.*.*.*.db',"
                                                                "\n" "or use ':memory:' (see sqlite.org/inmemorydb.html)"},
+        {"db-commit",    "NUMBER", "50",                       "set NUMBER of milliseconds to group database writes"
+                                                               "\n" "into a single transaction, from a separate thread"},
+        {"db-queue",     "NUMBER", "4096",                     "set NUMBER of maximum pending database writes,"
+                                                               "\n" "the loop waits for the next commit while full"},
+        {"cpu-db",       "LIST",   "",                         "set LIST of cpus to pin the thread of database writes"},
         {"lifetime",     "NUMBER", "0",                        "set NUMBER of minimum milliseconds to keep orders open,"
                                                                "\n" "otherwise open orders can be replaced anytime required"},
+        {"loop-budget",  "NUMBER", "300",                      "set NUMBER of maximum microseconds per loop turn"
+                                                               "\n" "to spend on periodic maintenance work"},
         {"matryoshka",   "URL",    "https://www.example.com/", "set Matryoshka link URL of the next UI"},
         {"ignore-sun",   "2",      0,                          "do not switch UI to light theme on daylight"},
         {"ignore-moon",  "1",      0,                          "do not switch UI to dark theme on moonlight"},
         {"autobot",      "1",      0,                          "automatically start trading on boot"},
         {"dustybot",     "1",      0,                          "do not automatically cancel all orders on exit"},
-        {"latency",      "1",      0,                          "check current HTTP latency (not from WS) and quit"},
+        {"latency",      "1",      0,                          "check current latency and quit, with HTTP round trips,"
+                                                               "\n" "WSS connects and (with '--exchange=SIM')"
+                                                               "\n" "order place/ack/cancel/ack cycles"},
+        {"latency-runs", "NUMBER", "10",                       "set NUMBER of samples taken by '--latency'"},
+        {"latency-file", "FILE",   "",                         "set FILE to save a JSON report of '--latency' results"},
         {"debug-orders", "1",      0,                          "print detailed output about exchange messages"},
         {"debug-quotes", "1",      0,                          "print detailed output about quoting engine"},
         {"debug-wallet", "1",      0,                          "print detailed output about target base position"}
@@ -76,7 +92,6 @@ namespace K {
     public:
       virtual void pressme(const mHotkey&, function<void()>) = 0;
       virtual void printme(mToScreen *const) = 0;
-      virtual void waitForUser() = 0;
       virtual const string stamp() = 0;
       virtual void logWar(const string&, const string&) = 0;
       virtual void logUI(const string&) = 0;
@@ -97,7 +112,6 @@ namespace K {
   class Client {
     public:
       uWS::Hub* socket = nullptr;
-      virtual void timer_Xs() = 0;
       virtual void welcome(mToClient&) = 0;
       virtual void clickme(mFromClient&, function<void(const json&)>) = 0;
   } *client = nullptr;
@@ -189,23 +203,26 @@ namespace K {
       {};
       void savedQuotingParameters() {
         broker.calculon.dummyMM.mode("saved");
-        levels.stats.ewma.calcFromHistory();
+        chores.push(levels.stats.ewma.calcFromHistory());
       };
-      void timer_1s(const unsigned int &tick) {
+      void timer_1s() {
         if (levels.warn_empty()) return;
-        levels.timer_1s();
-        if (!(tick % 60)) {
-          levels.timer_60s();
-          monitor.timer_60s();
-        }
+        chores.push(levels.timer_1s());
         wallet.safety.timer_1s();
         calcQuotes();
       };
+      void timer_60s() {
+        if (levels.empty()) return;
+        chores.push(levels.timer_60s());
+        chores.push({[&]() { monitor.timer_60s(); }});
+      };
       void calcQuotes() {
         if (broker.ready() and levels.ready() and wallet.ready()) {
           if (broker.calcQuotes()) {
+            gw->resumed();
             quote2orders(broker.calculon.quotes.ask);
             quote2orders(broker.calculon.quotes.bid);
+            sendOrders();
           } else cancelOrders();
         }
         broker.clear();
@@ -232,25 +249,46 @@ namespace K {
       void cancelOrders() {
         for (mOrder *const it : orders.working())
           cancelOrder(it);
+        sendOrders();
       };
       void manualSendOrder(mOrder raw) {
         raw.orderId = gw->randId();
         placeOrder(raw);
+        sendOrders();
       };
       void manualCancelOrder(const mRandId &orderId) {
         cancelOrder(orders.find(orderId));
+        sendOrders();
       };
     private:
+      vector<mOrder*> cancels,
+                      places;
+      void sendOrders() {
+        if (!cancels.empty()) {
+          gw->lifecycle.withdrawn(cancels);
+          gw->cancel_batch(cancels);
+          cancels.clear();
+        }
+        if (!places.empty()) {
+          gw->lifecycle.handed(places);
+          gw->place_batch(places);
+          places.clear();
+        }
+      };
       void placeOrder(const mOrder &raw) {
-        gw->place(orders.upsert(raw));
+        places.push_back(orders.upsert(raw));
+        gw->lifecycle.decided(places.back());
       };
       void replaceOrder(const mPrice &price, const bool &isPong, mOrder *const order) {
-        if (orders.replace(price, isPong, order))
+        if (orders.replace(price, isPong, order)) {
+          gw->lifecycle.decided(order);
+          gw->lifecycle.handed({order});
           gw->replace(order);
+        }
       };
       void cancelOrder(mOrder *const order) {
         if (orders.cancel(order))
-          gw->cancel(order);
+          cancels.push_back(order);
       };
   } *engine = nullptr;
 }
@@ -27,6 +27,8 @@ namespace K {
         gw->RAWDATA_ENTRY_POINT(mOrder, {
           orders.read_from_gw(rawdata);
           wallet.calcFundsAfterOrder(orders.updated, &gw->askForFees);
+          if (TRUEONCE(gw->askForFees))
+            timeline.after(0, [&]() { gw->askForWallet(); });
         });
         gw->RAWDATA_ENTRY_POINT(mTrade, {
           levels.stats.takerTrades.read_from_gw(rawdata);
@@ -40,11 +42,17 @@ namespace K {
         SCREEN_PRINTME
         SCREEN_PRESSME
       };
+      void waitTime() {
+        timeline.every(60e+3, [&]() {
+          if (!gw->countdown) timer_60s();
+        });
+      };
       void run() {
         options.handshake({
           {"gateway", gw->http              },
           {"gateway", gw->ws                },
           {"gateway", gw->fix               },
+          {"standby", gw->standby           },
           {"autoBot", options.num("autobot")
                         ? "yes"
                         : "no"              }
@@ -4,7 +4,7 @@
 namespace K {
   class SH: public Screen { public: SH() { screen = this; };
     private:
-      future<mHotkey> hotkey;
+      future<void> hotkey;
       unordered_map<mHotkey, function<void()>> hotFn;
       WINDOW *wBorder = nullptr,
              *wLog    = nullptr;
@@ -26,13 +26,13 @@ namespace K {
           } else log(prefix, reason, highlight);
         });
         if (options.num("latency")) {
-          gw->latency("HTTP read/write handshake", []() {
+          const unsigned int samples = max(1, options.num("latency-runs"));
+          gw->latency(samples, options.str("latency-file"), []() {
             options.handshake({
               {"gateway", gw->http}
             });
           });
-          exit("1 HTTP connection done" + Ansi::r(COLOR_WHITE)
-            + " (consider to repeat a few times this check)");
+          exit(to_string(samples) + " latency samples done");
         }
         gw->askForCancelAll = &qp.cancelOrdersAuto;
         engine->monitor.unlock          = &gw->unlock;
@@ -99,13 +99,6 @@ namespace K {
           refresh();
         };
       };
-      void waitForUser() {
-        if (!hotkey.valid() or hotkey.wait_for(chrono::nanoseconds(0)) != future_status::ready) return;
-        mHotkey ch = hotkey.get();
-        if (hotFn.find(ch) != hotFn.end())
-          hotFn.at(ch)();
-        hotkeys();
-      };
       const string stamp() {
         chrono::system_clock::time_point clock = Tclock;
         chrono::system_clock::duration t = clock.time_since_epoch();
@@ -268,7 +261,16 @@ namespace K {
       };
     private:
       void hotkeys() {
-        hotkey = ::async(launch::async, [&] { return (mHotkey)wgetch(wBorder); });
+        hotkey = ::async(launch::async, [&] {
+          topology.join("screen");
+          const mHotkey ch = (mHotkey)wgetch(wBorder);
+          topology.leave();
+          events->deferred([&, ch]() {
+            if (hotFn.find(ch) != hotFn.end())
+              hotFn.at(ch)();
+            hotkeys();
+          });
+        });
       };
 #if CAN_RESIZE
       function<void()> resize = [&]() {
@@ -422,7 +424,9 @@ namespace K {
           wattron(wBorder, COLOR_PAIR(COLOR_GREEN));
           waddstr(wBorder, (" 1 " + gw->base + " = ").data());
           wattron(wBorder, A_BOLD);
-          waddstr(wBorder, str8(engine->levels.fairValue).data());
+          char fairValue[352];
+          strX(fairValue, engine->levels.fairValue, 8);
+          waddstr(wBorder, fairValue);
           wattroff(wBorder, A_BOLD);
           waddstr(wBorder, (" " + gw->quote).data());
           wattroff(wBorder, COLOR_PAIR(COLOR_GREEN));
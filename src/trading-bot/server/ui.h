@@ -12,9 +12,18 @@ namespace K {
             public Client { public: UI() { client = this; };
     private:
       int connections = 0;
+      struct mOutbox {
+                    string addr,
+                           dirty;
+                    size_t buffered = 0;
+                    mClock behind   = 0;
+        unsigned long long dropped  = 0;
+      };
+      unordered_map<uWS::WebSocket<uWS::SERVER>*, mOutbox> outboxes;
       unordered_map<char, function<json()>> hello;
       unordered_map<char, function<void(json&)>> kisses;
-      unordered_map<mMatter, string> queue;
+      unordered_map<mMatter, function<const string()>> queue;
+      mPublisher publisher;
     protected:
       void waitWebAdmin() {
         if (!socket) return;
@@ -32,9 +41,11 @@ namespace K {
           if (connections > options.num("client-limit")) {
             screen->log("UI", "--client-limit=" + options.str("client-limit") + " reached by", addr);
             webSocket->close();
-          }
+          } else webSocket->setUserData(&(outboxes[webSocket] = {addr}));
         });
         client->onDisconnection([&](uWS::WebSocket<uWS::SERVER> *webSocket, int code, char *message, size_t length) {
+          webSocket->setUserData(nullptr);
+          outboxes.erase(webSocket);
           onDisconnection();
           screen->logUIsess(connections, cleanAddress(webSocket->getAddress().address));
         });
@@ -49,6 +60,7 @@ namespace K {
         });
         client->onMessage([&](uWS::WebSocket<uWS::SERVER> *webSocket, const char *message, size_t length, uWS::OpCode opCode) {
           if (length < 2) return;
+          const mTurn turn;
           const string response = onMessage(
             string(message, length),
             !options.str("whitelist").empty()
@@ -63,17 +75,44 @@ namespace K {
                 : uWS::OpCode::TEXT
             );
         });
-        broadcast = [this, client](const mMatter &type, string msg) {
-          msg.insert(msg.begin(), (char)type);
-          msg.insert(msg.begin(), (char)mPortal::Kiss);
-          events->deferred([client, msg]() {
-            client->broadcast(msg.data(), msg.length(), uWS::OpCode::TEXT);
+        topology.pin("ui", options.str("cpu-ui"));
+        publisher.start("ui");
+        broadcast = [this](const mMatter &type, const function<const string()> &snapshot) {
+          publisher.push([this, type, snapshot]() {
+            const shared_ptr<const string> msg = make_shared<const string>(
+              string(1, (char)mPortal::Kiss) + (char)type + snapshot()
+            );
+            events->deferred([this, type, msg]() {
+              deliver(type, *msg);
+            });
           });
         };
+        engine->monitor.clients = [&]() {
+          json clients = json::array();
+          for (const unordered_map<uWS::WebSocket<uWS::SERVER>*, mOutbox>::value_type &it : outboxes)
+            clients.push_back({
+              {    "addr", it.second.addr                                  },
+              {"buffered", it.second.buffered                              },
+              { "dropped", it.second.dropped                               },
+              {  "behind", it.second.behind ? Tstamp - it.second.behind : 0}
+            });
+          return clients;
+        };
+      };
+      void waitTime() {
+        if (!socket) return;
+        timeline.after(1e+3 * (qp.delayUI ?: 1), [&]() {
+          laggards();
+          if (qp.delayUI) timer_Xs();
+          waitTime();
+        });
       };
       void run() {
         send = send_nowhere;
       };
+      void end() {
+        publisher.stop();
+      };
     public:
       void welcome(mToClient &data) {
         if (!socket) return;
@@ -94,12 +133,71 @@ namespace K {
             fn(butterfly);
         };
       };
+    private:
       void timer_Xs() {
-        for (unordered_map<mMatter, string>::value_type &it : queue)
+        for (unordered_map<mMatter, function<const string()>>::value_type &it : queue)
           broadcast(it.first, it.second);
         queue.clear();
       };
-    private:
+      void deliver(const mMatter &type, const string &msg) {
+        for (unordered_map<uWS::WebSocket<uWS::SERVER>*, mOutbox>::value_type &it : outboxes) {
+          mOutbox &outbox = it.second;
+          if (outbox.buffered > (size_t)options.num("client-bytes")) {
+            if (!outbox.behind) outbox.behind = Tstamp;
+            if (coalesce(type)) {
+              if (outbox.dirty.find((char)type) == string::npos)
+                outbox.dirty += (char)type;
+              outbox.dropped++;
+              continue;
+            }
+          } else {
+            outbox.behind = 0;
+            if (resync(it.first, outbox, type)) continue;
+          }
+          write(it.first, msg);
+        }
+      };
+      const bool resync(uWS::WebSocket<uWS::SERVER> *const webSocket, mOutbox &outbox, const mMatter &type) {
+        if (outbox.dirty.empty()) return false;
+        string dirty;
+        dirty.swap(outbox.dirty);
+        for (const char &it : dirty)
+          if (hello.find(it) != hello.end()) {
+            const json reply = hello.at(it)();
+            if (!reply.is_null())
+              write(webSocket, string(1, (char)mPortal::Hello) + it + reply.dump());
+          }
+        return dirty.find((char)type) != string::npos;
+      };
+      void laggards() {
+        vector<uWS::WebSocket<uWS::SERVER>*> slow;
+        for (const unordered_map<uWS::WebSocket<uWS::SERVER>*, mOutbox>::value_type &it : outboxes)
+          if (it.second.behind and Tstamp > it.second.behind
+            and Tstamp - it.second.behind > (mClock)options.num("client-lag")
+          ) {
+            screen->log("UI", "--client-lag=" + options.str("client-lag") + " reached by", it.second.addr);
+            slow.push_back(it.first);
+          }
+        for (uWS::WebSocket<uWS::SERVER> *const it : slow) it->close();
+      };
+      static void write(uWS::WebSocket<uWS::SERVER> *const webSocket, const string &msg) {
+        ((mOutbox*)webSocket->getUserData())->buffered += msg.length();
+        webSocket->send(msg.data(), msg.length(), uWS::OpCode::TEXT,
+          [](uWS::WebSocket<uWS::SERVER> *webSocket, void *data, bool cancelled, void *reserved) {
+            mOutbox *const outbox = (mOutbox*)webSocket->getUserData();
+            if (outbox) outbox->buffered -= min(outbox->buffered, (size_t)data);
+          }, (void*)msg.length()
+        );
+      };
+      static const bool coalesce(const mMatter &type) {
+        return type == mMatter::FairValue
+            or type == mMatter::MarketData
+            or type == mMatter::QuoteStatus
+            or type == mMatter::Position
+            or type == mMatter::ApplicationState
+            or type == mMatter::TradeSafetyValue
+            or type == mMatter::TargetBasePosition;
+      };
       void sendAsync(mToClient &data) {
         data.send = [&]() {
           send(data);
@@ -165,13 +263,14 @@ namespace K {
         screen->logUI("HTTP" + string(context ? 1 : 0, 'S'));
         return context;
       };
-      function<void(const mMatter &type, string msg)> broadcast = [](const mMatter &type, string msg) {};
+      function<void(const mMatter&, const function<const string()>&)> broadcast = [](const mMatter &type, const function<const string()> &snapshot) {};
       function<void(const mToClient&)> send;
       function<void(const mToClient&)> send_nowhere = [](const mToClient &data) {};
       function<void(const mToClient&)> send_somewhere = [&](const mToClient &data) {
+        const function<const string()> snapshot = data.snapshot();
         if (data.realtime())
-          broadcast(data.about(), data.blob().dump());
-        else queue[data.about()] = data.blob().dump();
+          broadcast(data.about(), snapshot);
+        else queue[data.about()] = snapshot;
       };
       void onConnection() {
         if (!connections++) send = send_somewhere;
@@ -20,6 +20,547 @@ namespace K {
         }
       }
     }
+    GIVEN("mClockwork") {
+      const mClock epoch = chrono::duration_cast<chrono::milliseconds>(
+        Tclock.time_since_epoch()
+      ).count();
+      WHEN("defaults") {
+        THEN("epoch") {
+          REQUIRE(Tstamp >= epoch);
+          REQUIRE(Tstamp - epoch < 1e+3);
+        }
+      }
+      WHEN("cached") {
+        REQUIRE_NOTHROW(clockwork.tick());
+        const mClock turn = Tstamp;
+        this_thread::sleep_for(chrono::milliseconds(3));
+        THEN("per turn") {
+          REQUIRE(Tstamp == turn);
+          REQUIRE(clockwork.fresh() > turn);
+          REQUIRE_NOTHROW(clockwork.tock());
+          REQUIRE(Tstamp > turn);
+        }
+      }
+      WHEN("frozen") {
+        REQUIRE_NOTHROW(clockwork.freeze(1e+12));
+        THEN("virtual") {
+          REQUIRE(Tstamp == 1e+12);
+          REQUIRE_NOTHROW(clockwork.shift(1500));
+          REQUIRE(Tstamp == 1e+12 + 1500);
+          REQUIRE(clockwork.fresh() == Tstamp);
+          REQUIRE_NOTHROW(clockwork.thaw());
+          REQUIRE(Tstamp >= epoch);
+        }
+      }
+    }
+    GIVEN("mTimeline") {
+      mTimeline wheel;
+      unsigned int once = 0,
+                   many = 0,
+                   none = 0;
+      const mClock now = Tstamp;
+      WHEN("assigned") {
+        REQUIRE_NOTHROW(wheel.after(50, [&]() { ++once; }));
+        REQUIRE_NOTHROW(wheel.every(20, [&]() { ++many; }));
+        REQUIRE_NOTHROW(wheel.cancel(wheel.after(10, [&]() { ++none; })));
+        REQUIRE_NOTHROW(wheel.after(5e+3, [&]() { ++none; }));
+        THEN("fired") {
+          REQUIRE_NOTHROW(wheel.advance(now + 30));
+          REQUIRE(once == 0);
+          REQUIRE(many == 1);
+          REQUIRE(wheel.idle() <= 40);
+          REQUIRE_NOTHROW(wheel.advance(now + 105));
+          REQUIRE(once == 1);
+          REQUIRE(many == 5);
+          REQUIRE(none == 0);
+          REQUIRE_NOTHROW(wheel.advance(now + 6e+3));
+          REQUIRE(once == 1);
+          REQUIRE(none == 1);
+        }
+      }
+    }
+    GIVEN("mChores") {
+      mChores slices;
+      unsigned int done = 0;
+      WHEN("assigned") {
+        REQUIRE_NOTHROW(slices.push({
+          [&]() { ++done; },
+          [&]() { ++done; },
+          [&]() { ++done; }
+        }));
+        THEN("amortized") {
+          REQUIRE(slices.run(0));
+          REQUIRE(done == 0);
+          REQUIRE(slices.run(0));
+          REQUIRE(done == 1);
+          REQUIRE(slices.size() == 2);
+          REQUIRE_NOTHROW(clockwork.tick());
+          REQUIRE_NOTHROW(this_thread::sleep_for(chrono::milliseconds(2)));
+          REQUIRE(slices.run(1e+3));
+          REQUIRE_NOTHROW(clockwork.tock());
+          REQUIRE(done == 1);
+          REQUIRE_NOTHROW(clockwork.tick());
+          REQUIRE_FALSE(slices.run(1e+3));
+          REQUIRE_NOTHROW(clockwork.tock());
+          REQUIRE(done == 3);
+          REQUIRE_FALSE(slices.run(0));
+        }
+      }
+    }
+    GIVEN("mWorkers") {
+      mWorkers workers;
+      unsigned int done = 0;
+      WHEN("defaults") {
+        THEN("stopped") {
+          REQUIRE_FALSE(workers.push([]() {}));
+          REQUIRE_FALSE(workers.drain());
+        }
+      }
+      WHEN("assigned") {
+        REQUIRE_NOTHROW(workers.start(2, 8));
+        for (unsigned int i = 0; i < 3; ++i)
+          REQUIRE(workers.push([&]() {
+            workers.reply([&]() { ++done; });
+          }));
+        THEN("replied") {
+          while (workers.drain() or done < 3)
+            this_thread::sleep_for(chrono::milliseconds(1));
+          REQUIRE(done == 3);
+          REQUIRE_NOTHROW(workers.stop());
+          REQUIRE_FALSE(workers.push([]() {}));
+        }
+      }
+    }
+    GIVEN("mTopology") {
+      json joined,
+           left;
+      WHEN("assigned") {
+        REQUIRE_NOTHROW(topology.pin("units", "0"));
+        thread([&]() {
+          topology.join("units");
+          joined = topology.stats();
+          topology.leave();
+          left = topology.stats();
+        }).join();
+        THEN("measured") {
+          REQUIRE(joined["units"]["threads"] == 1);
+          REQUIRE(joined["units"]["cpus"] == "0");
+          REQUIRE(left.count("units") == 0);
+        }
+      }
+    }
+    GIVEN("mQueue") {
+      mQueue<unsigned int> queue;
+      unsigned int k = 0,
+                   sum = 0;
+      WHEN("assigned") {
+        vector<thread> producers;
+        for (unsigned int i = 0; i < 4; ++i)
+          producers.push_back(thread([&queue]() {
+            for (unsigned int j = 1; j <= 1000; ++j) queue.push(j);
+          }));
+        for (thread &it : producers) it.join();
+        THEN("consumed") {
+          while (queue.pop(k)) sum += k;
+          REQUIRE(sum == 4 * 500500);
+          REQUIRE_FALSE(queue.pop(k));
+        }
+      }
+    }
+    GIVEN("mJournal") {
+      mJournal journal;
+      vector<unsigned int> written;
+      unsigned int batches = 0;
+      journal.commit = [&](const vector<function<void()>> &batch) {
+        for (const function<void()> &it : batch) it();
+        batches++;
+      };
+      WHEN("assigned") {
+        journal.start(1e+3, 64);
+        for (unsigned int i = 0; i < 100; ++i)
+          journal.push([&written, i]() { written.push_back(i); });
+        journal.stop();
+        THEN("drained in order") {
+          REQUIRE(written.size() == 100);
+          REQUIRE(written.front() == 0);
+          REQUIRE(written.back() == 99);
+          REQUIRE(is_sorted(written.begin(), written.end()));
+          REQUIRE(batches < 100);
+          REQUIRE(journal.stats()["rows"] == 100);
+          REQUIRE(journal.stats()["queue"] == 0);
+        }
+        THEN("written at once when stopped") {
+          journal.push([&written]() { written.push_back(100); });
+          REQUIRE(written.back() == 100);
+        }
+      }
+    }
+    GIVEN("mPublisher") {
+      mPublisher publisher;
+      vector<unsigned int> published;
+      WHEN("assigned") {
+        publisher.start("ui");
+        for (unsigned int i = 0; i < 1000; ++i)
+          publisher.push([&published, i]() { published.push_back(i); });
+        publisher.stop();
+        THEN("drained in order") {
+          REQUIRE(published.size() == 1000);
+          REQUIRE(is_sorted(published.begin(), published.end()));
+          REQUIRE(publisher.stats()["pending"] == 0);
+          REQUIRE(publisher.stats()["published"] == 1000);
+        }
+      }
+    }
+    GIVEN("mBudget") {
+      mBudget budget;
+      WHEN("assigned") {
+        REQUIRE_NOTHROW(budget.limit(0, 8));
+        REQUIRE_NOTHROW(budget.weight("levels", 2));
+        THEN("throttled") {
+          REQUIRE(budget.take("levels"));
+          REQUIRE(budget.take("levels"));
+          REQUIRE(budget.take("levels"));
+          REQUIRE_FALSE(budget.take("levels"));
+          REQUIRE(budget.take("place", true));
+          REQUIRE(budget.take("place", true));
+          REQUIRE(budget.stats()["tokens"] == 0);
+          REQUIRE(budget.stats()["endpoints"]["levels"]["throttled"] == 1);
+          for (unsigned int i = 0; i < 20; ++i)
+            REQUIRE(budget.take("cancel", true));
+          REQUIRE(budget.stats()["tokens"] == -8);
+        }
+      }
+    }
+    GIVEN("mFailover") {
+      mFailover failover;
+      WHEN("assigned") {
+        REQUIRE(failover.down());
+        REQUIRE_FALSE(failover.down());
+        THEN("measured") {
+          this_thread::sleep_for(chrono::milliseconds(5));
+          REQUIRE(failover.up());
+          REQUIRE_FALSE(failover.up());
+          REQUIRE(failover.gap() >= 5);
+          REQUIRE(failover.stats()["drops"] == 2);
+          REQUIRE(failover.stats()["worst"] == failover.gap());
+        }
+      }
+    }
+    GIVEN("mHistogram") {
+      mHistogram histogram;
+      WHEN("assigned") {
+        for (mClock i = 1; i <= 1000; ++i)
+          histogram.record(i * 1000);
+        THEN("percentiles") {
+          REQUIRE(histogram.count() == 1000);
+          REQUIRE(histogram.percentile(0) == 1000);
+          REQUIRE(histogram.percentile(50) == Approx(500000).epsilon(0.01));
+          REQUIRE(histogram.percentile(99) == Approx(990000).epsilon(0.01));
+          REQUIRE(histogram.percentile(100) == 1000000);
+          REQUIRE(histogram.stats()["p90"] == histogram.percentile(90));
+          REQUIRE_NOTHROW(histogram.record(5));
+          REQUIRE(histogram.percentile(0) == 5);
+        }
+      }
+    }
+    GIVEN("mLifecycle") {
+      mLifecycle lifecycle;
+      mOrder order("a", mSide::Bid, 1234.5, 0.1, false);
+      WHEN("assigned") {
+        REQUIRE_NOTHROW(lifecycle.decided(&order));
+        REQUIRE_NOTHROW(lifecycle.handed({&order}));
+        REQUIRE_NOTHROW(lifecycle.sent(&order));
+        REQUIRE_NOTHROW(lifecycle.read(mOrder("a", "1", mStatus::Working, 0, 0, 0), &order));
+        REQUIRE_NOTHROW(lifecycle.read(mOrder("a", "1", mStatus::Working, 1234.5, 0, 0.02), &order));
+        REQUIRE_NOTHROW(lifecycle.read(mOrder("a", "1", mStatus::Working, 1234.5, 0, 0.03), &order));
+        const mClock handed = order.stamps.handed;
+        REQUIRE_NOTHROW(lifecycle.withdrawn({&order}));
+        REQUIRE_NOTHROW(lifecycle.canceled(&order));
+        REQUIRE_NOTHROW(lifecycle.read(mOrder("a", "1", mStatus::Terminated, 0, 0, 0), &order));
+        THEN("measured") {
+          REQUIRE(order.stamps.decided <= order.stamps.handed);
+          REQUIRE(order.stamps.sent <= order.stamps.acked);
+          REQUIRE(order.stamps.handed == handed);
+          REQUIRE(order.stamps.filled.size() == 2);
+          REQUIRE(order.stamps.withdrawn <= order.stamps.canceled);
+          REQUIRE(order.stamps.canceled <= order.stamps.closed);
+          REQUIRE(lifecycle.stats()["queue"]["count"] == 1);
+          REQUIRE(lifecycle.stats()["gateway"]["count"] == 1);
+          REQUIRE(lifecycle.stats()["ack"]["count"] == 1);
+          REQUIRE(lifecycle.stats()["fill"]["count"] == 2);
+          REQUIRE(lifecycle.stats()["cancel"]["count"] == 1);
+          REQUIRE(lifecycle.last().empty());
+          REQUIRE_NOTHROW(lifecycle.roll());
+          REQUIRE(lifecycle.last()["ack"]["count"] == 1);
+          REQUIRE(lifecycle.stats()["ack"]["count"] == 0);
+        }
+      }
+      WHEN("replaced") {
+        REQUIRE_NOTHROW(lifecycle.decided(&order));
+        REQUIRE_NOTHROW(lifecycle.handed({&order}));
+        REQUIRE_NOTHROW(lifecycle.read(mOrder("a", "1", mStatus::Working, 1234.5, 0, 0.02), &order));
+        REQUIRE_NOTHROW(lifecycle.decided(&order));
+        REQUIRE_NOTHROW(lifecycle.handed({&order}));
+        REQUIRE_NOTHROW(lifecycle.read(mOrder("a", "1", mStatus::Working, 1234.6, 0, 0.03), &order));
+        THEN("fills kept") {
+          REQUIRE_FALSE(order.stamps.sent);
+          REQUIRE(order.stamps.filled.size() == 2);
+          REQUIRE(lifecycle.stats()["queue"]["count"] == 2);
+          REQUIRE(lifecycle.stats()["gateway"]["count"] == 0);
+          REQUIRE(lifecycle.stats()["fill"]["count"] == 2);
+        }
+      }
+    }
+    GIVEN("mText") {
+      WHEN("assigned") {
+        THEN("signed") {
+          REQUIRE(mText::oHmac256("what do ya want for nothing?", "Jefe")
+            == "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+          REQUIRE(mText::oHmac256("what do ya want for nothing?", "Jefe")
+            == "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+          REQUIRE(mText::oHmac256("The quick brown fox jumps over the lazy dog", "key")
+            == "f7bc83f430538424b13298e6aa6fb143ef4d59a14946175997479dbc2d1a3cd8");
+          REQUIRE(mText::oHmac256("what do ya want for nothing?", "Jefe", true)
+            == mText::oHex("5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"));
+          REQUIRE(mText::oHmac1("", "") == "fbdb1d1b18aa6c08324b7d64b71fb76370690e1d");
+          REQUIRE(mText::oMd5("") == "D41D8CD98F00B204E9800998ECF8427E");
+          REQUIRE(mText::oB64("") == "");
+          REQUIRE(mText::oB64("K") == "Sw==");
+          REQUIRE(mText::oB64("Kr") == "S3I=");
+          REQUIRE(mText::oB64("Kry") == "S3J5");
+          REQUIRE(mText::oB64decode("S3J5cHRv") == "Krypto");
+          REQUIRE(mText::oB64decode("S3I=") == "Kr");
+          REQUIRE(mText::oB64decode(mText::oB64(string("\0\xff\x10K", 4))) == string("\0\xff\x10K", 4));
+          REQUIRE(mText::oZip(mText::oB64decode("8y6qLCjJ1y0pSkzJzEvXTcovAQA=")) == "Krypto-trading-bot");
+          REQUIRE(mText::oZip("Krypto") == "");
+        }
+      }
+    }
+    GIVEN("strX") {
+      char k[352];
+      WHEN("assigned") {
+        THEN("formatted") {
+          REQUIRE(str8(1234.56) == "1234.56000000");
+          REQUIRE(str8(-0.000000005) == "-0.00000001");
+          REQUIRE(str8(-0.000000001) == "0.00000000");
+          REQUIRE(string(k, strX(k, 1234.5, 8, true)) == "1234.5");
+          REQUIRE(string(k, strX(k, 1234, 8, true)) == "1234");
+          REQUIRE(string(k, strX(k, 1e+300, 2)) == strX(1e+300, 2));
+          REQUIRE(strX(0.125, 2) == "0.12");
+          REQUIRE(strX(0.375, 2) == "0.38");
+          REQUIRE(strX(2.5, 0) == "2");
+          REQUIRE(strX(3.5, 0) == "4");
+          REQUIRE(strX(-2.5, 0) == "-2");
+          REQUIRE(strX(1.005, 2) == "1.00");
+          REQUIRE(strX(-0.0, 2) == "0.00");
+          REQUIRE(strX(-0.004, 2) == "0.00");
+          REQUIRE(strX(-0.005, 2) == "-0.01");
+          REQUIRE(strX(-0.5, 0) == "0");
+          REQUIRE(strX(-1e+308, 40).length() == 328);
+          REQUIRE(strX(0.1, 40) == strX(0.1, 17));
+          unsigned int mismatches = 0;
+          for (unsigned int i = 0; i < 64; ++i)
+            for (const double &it : {
+              i / 1024.0, i * 0.005, -(i + 1.5), i * 9973.0000001 / 3, pow(10, i % 20) * 1.5
+            })
+              for (const unsigned int &X : { 0u, 2u, 8u })
+                if (string(k, strX(k, it, X)) != string(k, sprintf(k, "%.*f", X, it)))
+                  ++mismatches;
+          REQUIRE(mismatches == 0);
+          REQUIRE(decimals(0.01) == 2);
+          REQUIRE(decimals(5e-5) == 5);
+          REQUIRE(decimals(1) == 0);
+          REQUIRE(strD("1234.56") == 1234.56);
+          REQUIRE(strD("-0.00012345") == -0.00012345);
+          REQUIRE(strD("1e-3") == 0.001);
+          REQUIRE(strD("12345678901234567890") == 12345678901234567890.0);
+        }
+      }
+    }
+    GIVEN("mFix") {
+      mFix fix("S", "T", "BTC-USD");
+      mFix::mReport report;
+      string data = "8=FIX.4.2|9=65|35=8|49=T|56=S|34=7|11=abc|37=X1|39=1|54=2|31=1234.5|32=0.5|38=2|10=065|";
+      replace(data.begin(), data.end(), '|', '\x01');
+      WHEN("assigned") {
+        REQUIRE_FALSE(fix.order("abc", mSide::Bid, "1234.5", "2", mOrderType::Limit, mTimeInForce::GTC, true));
+        THEN("encoded") {
+          REQUIRE(mFix::frame(fix.message()) == fix.message().length());
+          REQUIRE(mFix::frame(fix.message().substr(0, 20)) == 0);
+          REQUIRE(mFix::parse(fix.message(), report));
+          REQUIRE(report.type == "D");
+          REQUIRE(report.clOrdId == "abc");
+          REQUIRE(report.price == "1234.5");
+          REQUIRE(fix.message().find("\x01" "55=BTC-USD\x01" "54=1\x01" "38=2\x01" "40=2\x01") != string_view::npos);
+          REQUIRE(fix.message().find("\x01" "18=6\x01" "10=") != string_view::npos);
+        }
+        THEN("decoded") {
+          REQUIRE(mFix::frame(data + "8=FIX") == data.length());
+          REQUIRE(mFix::parse(data, report));
+          REQUIRE(report.order().orderId == "abc");
+          REQUIRE(report.order().exchangeId == "X1");
+          REQUIRE(report.order().status == mStatus::Working);
+          REQUIRE(report.order().side == mSide::Ask);
+          REQUIRE(report.order().price == 1234.5);
+          REQUIRE(report.order().tradeQuantity == 0.5);
+          data[data.length() - 2] = '6';
+          REQUIRE_FALSE(mFix::parse(data, report));
+        }
+      }
+      WHEN("oversized") {
+        const string text(8192, 'x');
+        REQUIRE_FALSE(fix.logon(30, {{58, text}}));
+        THEN("grown") {
+          REQUIRE(fix.message().length() > 8192);
+          REQUIRE(mFix::frame(fix.message()) == fix.message().length());
+          REQUIRE(mFix::parse(fix.message(), report));
+          REQUIRE(report.type == "A");
+          REQUIRE(report.text == text);
+          REQUIRE_FALSE(mFix::oversized(fix.message()));
+        }
+        THEN("rejected") {
+          REQUIRE(mFix::oversized("8=FIX.4.2\x01" "9=99999999\x01" "35=8\x01"));
+          REQUIRE(mFix::oversized(string(2 << 20, 'x')));
+        }
+      }
+    }
+    GIVEN("mFields") {
+      mLevels levels;
+      const mFields<mLevels> book({
+        {"bids/*",   [](mLevels &k, const double &num, const string &str) { k.bids.emplace_back(); }},
+        {"bids/*/0", [](mLevels &k, const double &num, const string &str) { k.bids.back().price = num; }},
+        {"bids/*/1", [](mLevels &k, const double &num, const string &str) { k.bids.back().size = num; }},
+        {"asks/0",   [](mLevels &k, const double &num, const string &str) { k.asks.emplace_back(); }},
+        {"asks/0/0", [](mLevels &k, const double &num, const string &str) { k.asks.back().price = num; }}
+      });
+      WHEN("assigned") {
+        THEN("decoded") {
+          REQUIRE(book.decode("{\"asks\":[[\"1234.58\",1],[\"1234.59\",2]],\"seq\":{\"bids\":[[1]]},"
+            "\"bids\":[[\"1234.57\",0.12345678],[1234.56,3]]}", levels));
+          REQUIRE(levels.bids.size() == 2);
+          REQUIRE(levels.bids[0].price == Approx(1234.57));
+          REQUIRE(levels.bids[0].size == Approx(0.12345678));
+          REQUIRE(levels.bids[1].price == Approx(1234.56));
+          REQUIRE(levels.bids[1].size == 3);
+          REQUIRE(levels.asks.size() == 1);
+          REQUIRE(levels.asks[0].price == Approx(1234.58));
+          REQUIRE(levels.asks[0].size == 0);
+          REQUIRE_FALSE(book.decode("{\"bids\":[[1,2]", levels));
+        }
+        THEN("odd paths") {
+          mLevels odd;
+          REQUIRE_NOTHROW(mFields<mLevels>({
+            {"",                   [](mLevels &k, const double &num, const string &str) { }},
+            {"asks/",              [](mLevels &k, const double &num, const string &str) { }},
+            {"asks/99999999999/0", [](mLevels &k, const double &num, const string &str) { }}
+          }));
+          const mFields<mLevels> keys({
+            {"a//b", [](mLevels &k, const double &num, const string &str) { k.bids.push_back(mLevel(num, 0)); }}
+          });
+          REQUIRE(keys.decode("{\"a\":{\"\":{\"b\":1234.57}},\"b\":[1]}", odd));
+          REQUIRE(odd.bids.size() == 1);
+          REQUIRE(odd.bids[0].price == Approx(1234.57));
+        }
+        THEN("error reply") {
+          mLevels error, partial;
+          REQUIRE_FALSE(GwPoloniex::book("{\"error\":\"Invalid currency pair.\"}", error));
+          REQUIRE(error.empty());
+          REQUIRE_FALSE(GwPoloniex::book("{\"bids\":[[\"1234.57\",1]]}", partial));
+          REQUIRE(GwPoloniex::book("{\"asks\":[[\"1234.58\",1]],\"bids\":[],\"isFrozen\":\"0\"}", levels));
+          REQUIRE(levels.bids.empty());
+          REQUIRE(levels.asks.size() == 1);
+        }
+      }
+    }
+    GIVEN("GwSim") {
+      GwSim sim(500, 0, 1, 1e+3, 0, 50);
+      vector<mOrder> replies;
+      sim.write_mOrder   = [&](const mOrder &k) { replies.push_back(k); };
+      sim.write_mLevels  = [](const mLevels&) {};
+      sim.write_mWallets = [](const mWallets&) {};
+      sim.handshake();
+      WHEN("assigned") {
+        const struct mFrozen {
+          mFrozen() { clockwork.freeze(Tstamp); };
+          ~mFrozen() { clockwork.thaw(); };
+        } frozen;
+        for (unsigned int i = 0; i < 16; ++i) {
+          sim.place(to_string(i), mSide::Bid, "250.00", "0.010", mOrderType::Limit, mTimeInForce::GTC, true);
+          sim.cancel(to_string(i), "");
+        }
+        sim.cancel("unknown", "");
+        for (unsigned int i = 0; i < 3; ++i) {
+          clockwork.shift(1e+3);
+          timeline.advance();
+        }
+        THEN("replied in order") {
+          REQUIRE(replies.size() == 33);
+          for (unsigned int i = 0; i < 16; ++i) {
+            REQUIRE(replies[i * 2].orderId == to_string(i));
+            REQUIRE(replies[i * 2].status == mStatus::Working);
+            REQUIRE(replies[i * 2 + 1].orderId == to_string(i));
+            REQUIRE(replies[i * 2 + 1].status == mStatus::Terminated);
+          }
+          REQUIRE(replies.back().orderId == "unknown");
+          REQUIRE(replies.back().status == mStatus::Terminated);
+        }
+      }
+      WHEN("levels read") {
+        vector<mClock> stamps;
+        sim.RAWDATA_ENTRY_POINT(mLevels, {
+          stamps.push_back(Tstamp);
+          this_thread::sleep_for(chrono::milliseconds(3));
+          stamps.push_back(Tstamp);
+        });
+        REQUIRE_NOTHROW(sim.write_mLevels(mLevels()));
+        THEN("stamped once per turn") {
+          REQUIRE(stamps.size() == 2);
+          REQUIRE(stamps.front() == stamps.back());
+          REQUIRE(clockwork.fresh() > stamps.back());
+        }
+      }
+      WHEN("handlers registered") {
+        const struct mFrozen {
+          mFrozen() { clockwork.freeze(Tstamp); };
+          ~mFrozen() { clockwork.thaw(); };
+        } frozen;
+        unsigned int connected = 0;
+        THEN("ready once") {
+          REQUIRE_FALSE(sim.ready());
+          REQUIRE_NOTHROW(sim.write_mTrade = [](const mTrade&) {});
+          REQUIRE_FALSE(sim.ready());
+          REQUIRE_NOTHROW(sim.write_mConnectivity = [&](const mConnectivity&) { ++connected; });
+          REQUIRE(sim.ready());
+          REQUIRE_FALSE(sim.ready());
+          REQUIRE_NOTHROW(clockwork.shift(5e+3));
+          REQUIRE_NOTHROW(timeline.advance());
+          REQUIRE(connected == 1);
+        }
+      }
+      WHEN("failed over") {
+        struct GwStandby: public GwSim {
+          using GwSim::GwSim;
+          using GwSim::promote;
+        } standby(500, 0, 1, 1e+3, 0, 50);
+        standby.ws      = "wss://primary";
+        standby.standby = "wss://standby";
+        mLevels book;
+        standby.write_mLevels       = [&](const mLevels &k) { book = k; };
+        standby.write_mConnectivity = [&](const mConnectivity &k) {
+          if (!k) book = mLevels();
+        };
+        standby.write_mLevels(mLevels({mLevel(499.99, 1)}, {mLevel(500.01, 1)}));
+        THEN("book dropped") {
+          REQUIRE_FALSE(book.bids.empty());
+          REQUIRE(standby.promote("disconnected"));
+          REQUIRE(standby.ws == "wss://standby");
+          REQUIRE(book.bids.empty());
+          REQUIRE(book.asks.empty());
+          REQUIRE_FALSE(standby.promote("disconnected"));
+          REQUIRE(standby.ws == "wss://standby");
+        }
+      }
+    }
   }
 
   SCENARIO("BTC/EUR") {
@@ -300,6 +841,33 @@ namespace K {
       }
     }
 
+    GIVEN("mStdevs") {
+      mPrice fairValue = 0;
+      mStdevs stdev(fairValue);
+      REQUIRE_NOTHROW(stdev.mFromDb::push = [&]() {
+        INFO("push()");
+      });
+      WHEN("assigned") {
+        vector<function<void()>> slices;
+        for (unsigned int i = 0; i < 1100; ++i) {
+          REQUIRE_NOTHROW(fairValue = 200 + (i * 7 % 13));
+          REQUIRE_NOTHROW(slices = stdev.timer_1s(fairValue - (i % 3), fairValue + (i % 5)));
+        }
+        THEN("sliced by rows") {
+          REQUIRE(slices.size() == 2 * 3 + 2);
+          REQUIRE_FALSE(stdev.fair);
+          for (const function<void()> &slice : slices)
+            REQUIRE_NOTHROW(slice());
+          double mean = 0, sq = 0;
+          for (const mStdev &it : stdev) mean += it.fv;
+          mean /= stdev.size();
+          for (const mStdev &it : stdev) sq += pow(it.fv - mean, 2);
+          REQUIRE(stdev.fairMean == Approx(mean));
+          REQUIRE(stdev.fair == Approx(sqrt(sq / stdev.size())));
+          REQUIRE(stdev.top > 0);
+        }
+      }
+    }
     GIVEN("mEwma") {
       mPrice fairValue = 0;
       mEwma ewma(fairValue);
@@ -317,7 +885,8 @@ namespace K {
         });
         for (const mPrice &it : fairHistory) {
           REQUIRE_NOTHROW(fairValue = it);
-          REQUIRE_NOTHROW(ewma.timer_60s(0));
+          for (const function<void()> &slice : ewma.timer_60s(0))
+            REQUIRE_NOTHROW(slice());
         };
         REQUIRE_NOTHROW(qp.mediumEwmaPeriods = 20);
         REQUIRE_NOTHROW(qp._diffVLEP =
@@ -326,7 +895,8 @@ namespace K {
                         qp._diffSEP  =
                         qp._diffXSEP =
                         qp._diffUEP  = true);
-        REQUIRE_NOTHROW(ewma.calcFromHistory());
+        for (const function<void()> &slice : ewma.calcFromHistory())
+          REQUIRE_NOTHROW(slice());
         THEN("values") {
           REQUIRE(ewma.mgEwmaVL == Approx(266.1426832796));
           REQUIRE(ewma.mgEwmaL == Approx(264.4045182289));
@@ -349,7 +919,100 @@ namespace K {
             "}");
           }
         }
+        THEN("packed") {
+          mFairHistory restored;
+          vector<mClock> times(ewma.fairValue96h.size());
+          vector<double> values(times.size());
+          for (size_t i = 0; i < times.size(); ++i)
+            times[i] = ewma.fairValue96h.pack(times.size() - 1 - i, &values[i]);
+          REQUIRE(restored.width() == 1);
+          REQUIRE(restored.unpack(times, values));
+          REQUIRE(restored.rows == ewma.fairValue96h.rows);
+        }
+      }
+    }
+    GIVEN("mSeries") {
+      sqlite3 *db = nullptr;
+      REQUIRE(sqlite3_open(":memory:", &db) == SQLITE_OK);
+      REQUIRE(sqlite3_exec(db, "CREATE TABLE main.fairs (id INTEGER PRIMARY KEY AUTOINCREMENT,"
+        " json BLOB NOT NULL, time TIMESTAMP NOT NULL);", nullptr, nullptr, nullptr) == SQLITE_OK);
+      const function<const string(sqlite3_stmt *const, const string&, const function<void()>&)> step = [&](
+        sqlite3_stmt *const stmt, const string &name, const function<void()> &row
+      ) {
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+          if (row) row();
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        return rc == SQLITE_DONE ? string() : name + ": " + sqlite3_errmsg(db);
+      };
+      const function<const vector<mClock>(const string&)> column = [&](const string &sql) {
+        vector<mClock> values;
+        sqlite3_stmt *stmt = nullptr;
+        sqlite3_prepare_v2(db, sql.data(), sql.length() + 1, &stmt, nullptr);
+        step(stmt, sql, [&]() { values.push_back(sqlite3_column_int64(stmt, 0)); });
+        sqlite3_finalize(stmt);
+        return values;
+      };
+      mFairHistory written,
+                   restored;
+      string reason;
+      WHEN("appended") {
+        {
+          mSeries series;
+          series.step = step;
+          REQUIRE(series.open(db, &written, "main.fairs").empty());
+          for (unsigned int i = 0; i < 150; ++i) {
+            const double value = 1234.5 + i;
+            REQUIRE(series.append(1e+3 + i, &value, 0).empty());
+          }
+        }
+        mSeries series;
+        series.step = step;
+        REQUIRE(series.open(db, &restored, "main.fairs").empty());
+        THEN("rolled over") {
+          REQUIRE(column("SELECT rows FROM main.fairs_blocks ORDER BY id;") == vector<mClock>({64, 64, 22}));
+          REQUIRE(column("SELECT last FROM main.fairs_blocks ORDER BY id;") == vector<mClock>({1063, 1127, 1149}));
+        }
+        THEN("decoded") {
+          REQUIRE(series.load(0, reason));
+          REQUIRE(reason.empty());
+          REQUIRE(restored.size() == 150);
+          REQUIRE(restored.front() == 1234.5);
+          REQUIRE(restored.at(64) == 1234.5 + 64);
+          REQUIRE(restored.back() == 1234.5 + 149);
+        }
+        THEN("expired") {
+          REQUIRE(series.load(1100, reason));
+          REQUIRE(reason.empty());
+          REQUIRE(restored.size() == 50);
+          REQUIRE(restored.front() == 1234.5 + 100);
+          REQUIRE(column("SELECT rows FROM main.fairs_blocks ORDER BY id;") == vector<mClock>({64, 22}));
+        }
       }
+      WHEN("migrated") {
+        REQUIRE(sqlite3_exec(db, "INSERT INTO main.fairs (json,time) VALUES"
+          " ('1234.5',1000),('1235.5',2000),('1236.5',3000);", nullptr, nullptr, nullptr) == SQLITE_OK);
+        {
+          mSeries series;
+          series.step = step;
+          REQUIRE(series.open(db, &written, "main.fairs").empty());
+          REQUIRE(series.load(1500, reason));
+          REQUIRE(reason.empty());
+        }
+        THEN("legacy times") {
+          REQUIRE(written.rows == vector<mPrice>({1235.5, 1236.5}));
+          REQUIRE(column("SELECT COUNT(*) FROM main.fairs;") == vector<mClock>({0}));
+          REQUIRE(column("SELECT first FROM main.fairs_blocks;") == vector<mClock>({2000}));
+          REQUIRE(column("SELECT last FROM main.fairs_blocks;") == vector<mClock>({3000}));
+          mSeries series;
+          series.step = step;
+          REQUIRE(series.open(db, &restored, "main.fairs").empty());
+          REQUIRE(series.load(0, reason));
+          REQUIRE(restored.rows == written.rows);
+        }
+      }
+      sqlite3_close(db);
     }
 
     GIVEN("mBroker") {
@@ -365,6 +1028,7 @@ namespace K {
       wallet.quote = mWallet(1000, 0, "EUR");
       mBroker broker(orders, product, levels, wallet);
       WHEN("assigned") {
+        const mTurn turn;
         vector<mRandId> randIds;
         mClock time = Tstamp;
         REQUIRE_NOTHROW(randIds.push_back(mRandom::uuid36Id()));
@@ -415,6 +1079,20 @@ namespace K {
           REQUIRE(string::npos != orders.blob().dump().find("{\"exchangeId\":\"\",\"isPong\":false,\"latency\":0,\"orderId\":\"" + randIds[3] + "\",\"preferPostOnly\":true,\"price\":1234.5,\"quantity\":0.12345678,\"side\":1,\"status\":1,\"time\":" + to_string(time) + ",\"timeInForce\":2,\"type\":0}"));
           REQUIRE(string::npos != orders.blob().dump().find("{\"exchangeId\":\"\",\"isPong\":false,\"latency\":0,\"orderId\":\"" + randIds[4] + "\",\"preferPostOnly\":true,\"price\":1234.51,\"quantity\":0.12345679,\"side\":1,\"status\":1,\"time\":" + to_string(time) + ",\"timeInForce\":2,\"type\":0}"));
         }
+        THEN("snapshot") {
+          const string blob = orders.blob().dump();
+          function<const string()> snapshot;
+          REQUIRE_NOTHROW(snapshot = orders.snapshot());
+          REQUIRE_NOTHROW(orders.purge(orders.find(randIds[0])));
+          REQUIRE(snapshot() == blob);
+          REQUIRE(orders.snapshot()() == orders.blob().dump());
+          REQUIRE(orders.snapshot()() != blob);
+          REQUIRE_NOTHROW(levels.stats.ewma.mgEwmaM = 1234.5);
+          REQUIRE_NOTHROW(snapshot = levels.stats.snapshot());
+          REQUIRE_NOTHROW(levels.stats.ewma.mgEwmaM = 0);
+          REQUIRE(snapshot().find("\"ewmaMedium\":1234.5") != string::npos);
+          REQUIRE(levels.stats.snapshot()() == levels.stats.blob().dump());
+        }
       }
     }
   }